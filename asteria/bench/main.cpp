@@ -0,0 +1,414 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "../src/precompiled.hpp"
+#include "../src/simple_script.hpp"
+#include "../src/runtime/global_context.hpp"
+#include "../src/runtime/reference.hpp"
+#include "../src/llds/reference_stack.hpp"
+#include "../src/utils.hpp"
+#include <time.h>  // ::clock_gettime()
+#include <stdio.h>  // ::printf(), ::fgets()
+#include <unistd.h>  // ::getopt()
+
+namespace {
+using namespace asteria;
+
+// Allocations are counted by replacing the global allocation functions.
+::rocket::atomic<uint64_t> s_nallocs;
+
+// Each benchmark is a script which performs `__varg(0)` operations. It is also
+// executed with no operation, so setup costs can be subtracted.
+struct Benchmark
+  {
+    const char* name;
+    const char* source;
+  };
+
+constexpr Benchmark s_benchmarks[] =
+  {
+    { "arith_integer", R"__(
+        var n = __varg(0), s = 0;
+        for(var i = 0;  i < n;  ++i)
+          s = (s + i * 3) % 1000003;
+      )__" },
+
+    { "arith_real", R"__(
+        var n = __varg(0), x = 1.0;
+        for(var i = 0;  i < n;  ++i)
+          x = x * 0.999 + 1.5 / (i + 1.0);
+      )__" },
+
+    { "local_lookup", R"__(
+        var n = __varg(0), s = 0;
+        var a = 1, b = 2, c = 3;
+        for(var i = 0;  i < n;  ++i)
+          s = a + b + c;
+      )__" },
+
+    { "global_lookup", R"__(
+        var n = __varg(0), s;
+        for(var i = 0;  i < n;  ++i)
+          s = std;
+      )__" },
+
+    { "function_call", R"__(
+        var n = __varg(0), s = 0;
+        func inc(x) { return x + 1;  }
+        for(var i = 0;  i < n;  ++i)
+          s = inc(s);
+      )__" },
+
+    { "tail_call", R"__(
+        var n = __varg(0);
+        func count(k, s) {
+          if(k == 0)
+            return s;
+          return count(k - 1, s + 1);
+        }
+        count(n, 0);
+      )__" },
+
+    { "closure", R"__(
+        var n = __varg(0), s = 0;
+        func adder(k) { return func(x) { return x + k;  };  }
+        for(var i = 0;  i < n;  ++i)
+          s = adder(i)(s);
+      )__" },
+
+    { "for_each_array", R"__(
+        var n = __varg(0), s = 0;
+        var a = [ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 ];
+        for(var i = 0;  i < n;  i += 10)
+          for(each k, v -> a)
+            s += v;
+      )__" },
+
+    { "for_each_object", R"__(
+        var n = __varg(0), s = 0;
+        var o = { a: 1, b: 2, c: 3, d: 4, e: 5, f: 6, g: 7, h: 8, i: 9, j: 10 };
+        for(var i = 0;  i < n;  i += 10)
+          for(each k, v -> o)
+            s += v;
+      )__" },
+
+    { "member_access", R"__(
+        var n = __varg(0), s = 0;
+        var o = { x: { y: [ 1, 2, { z: 3 } ] } };
+        for(var i = 0;  i < n;  ++i)
+          s = o.x.y[2].z;
+      )__" },
+
+    { "exception", R"__(
+        var n = __varg(0), s = 0;
+        for(var i = 0;  i < n;  ++i)
+          try {
+            throw i;
+          }
+          catch(e)
+            s += e;
+      )__" },
+
+    { "gc_churn", R"__(
+        var n = __varg(0), g;
+        func leak() {
+          var f;
+          f = func() { return f;  };
+          g = f;
+        }
+        for(var i = 0;  i < n;  ++i)
+          leak();
+      )__" },
+  };
+
+struct Result
+  {
+    cow_string name;
+    double ns_per_op;
+    double allocs_per_op;
+  };
+
+struct Options
+  {
+    int64_t min_time_ms = 200;
+    int64_t repeat = 5;
+    double threshold = 10;
+    opt<cow_string> baseline;
+    cow_vector<cow_string> filters;
+  };
+
+[[noreturn]]
+int
+do_print_help_and_exit(const char* self)
+  {
+    ::printf(
+//       1         2         3         4         5         6         7      |
+// 4567890123456789012345678901234567890123456789012345678901234567890123456|
+"""""""""""""""""""""""""""""""""""""""""""""""""""""""""" R"'''''''''''''''(
+Usage: %s [OPTIONS] [NAME]...
+
+  -c FILE  compare results against the baseline in FILE
+  -h       show help message then exit
+  -l       list all benchmarks then exit
+  -m MS    run each measurement for at least MS milliseconds [default = 200]
+  -r N     repeat each measurement N times [default = 5]
+  -t PCT   report regressions above PCT percent [default = 10]
+
+If NAMEs are specified, only benchmarks whose names contain any of them are
+run.
+
+Results are written to standard output, one benchmark per line, with fields
+separated by tabs: the name, nanoseconds per operation, and allocations per
+operation. Lines that start with `#` are comments. Output of a previous run
+can be used as the baseline.
+
+When comparing against a baseline, the baseline values and the change of time
+are appended to each line, followed by `ok` or `regressed`. The exit status is
+non-zero if any benchmark has regressed in time or allocations.
+)'''''''''''''''" """"""""""""""""""""""""""""""""""""""""""""""""""""""""+1,
+// 4567890123456789012345678901234567890123456789012345678901234567890123456|
+//       1         2         3         4         5         6         7      |
+      self);
+
+    ::exit(0);
+  }
+
+[[noreturn]]
+int
+do_list_and_exit()
+  {
+    for(const auto& bench : s_benchmarks)
+      ::printf("%s\n", bench.name);
+
+    ::exit(0);
+  }
+
+int64_t
+do_parse_integer(const char* self, char opt, const char* str, int64_t min, int64_t max)
+  {
+    char* ep;
+    long long val = ::strtoll(str, &ep, 10);
+    if((*ep != 0) || (val < min) || (val > max)) {
+      ::fprintf(stderr, "%s: invalid argument for `-%c` -- '%s'\n", self, opt, str);
+      ::exit(2);
+    }
+    return static_cast<int64_t>(val);
+  }
+
+Options
+do_parse_command_line(int argc, char** argv)
+  {
+    Options opts;
+
+    int ch;
+    while((ch = ::getopt(argc, argv, "c:hlm:r:t:")) != -1) {
+      // Identify a single option.
+      switch(ch) {
+        case 'c':
+          opts.baseline = cow_string(optarg);
+          continue;
+
+        case 'h':
+          do_print_help_and_exit(argv[0]);
+
+        case 'l':
+          do_list_and_exit();
+
+        case 'm':
+          opts.min_time_ms = do_parse_integer(argv[0], 'm', optarg, 1, 600000);
+          continue;
+
+        case 'r':
+          opts.repeat = do_parse_integer(argv[0], 'r', optarg, 1, 1000);
+          continue;
+
+        case 't':
+          opts.threshold = static_cast<double>(do_parse_integer(argv[0], 't', optarg, 0, 1000));
+          continue;
+      }
+
+      // `getopt()` will have written an error message to standard error.
+      ::fprintf(stderr, "Try `%s -h` for help.\n", argv[0]);
+      ::exit(2);
+    }
+
+    ::std::for_each(argv + optind, argv + argc,
+        [&](const char* arg) { opts.filters.emplace_back(cow_string(arg));  });
+    return opts;
+  }
+
+bool
+do_is_selected(const Options& opts, const char* name)
+  {
+    if(opts.filters.empty())
+      return true;
+
+    return ::std::any_of(opts.filters.begin(), opts.filters.end(),
+                 [&](const cow_string& filter) { return ::std::strstr(name, filter.c_str()) != nullptr;  });
+  }
+
+int64_t
+do_now_ns()
+  noexcept
+  {
+    ::timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000 + ts.tv_nsec;
+  }
+
+struct Sample
+  {
+    int64_t ns;
+    uint64_t nallocs;
+  };
+
+Sample
+do_run_once(Simple_Script& code, int64_t nops)
+  {
+    // Use a new global context each time, so nothing is carried over.
+    Global_Context global;
+    Reference self = Reference::S_constant();
+    Reference_Stack stack;
+    Reference::S_temporary xref = { V_integer(nops) };
+    stack.emplace_back(::std::move(xref));
+
+    // The function is called directly. `Simple_Script::execute()` would reopen
+    // standard output, which truncates the file where results are written.
+    const cow_function& func = code;
+    uint64_t nallocs = s_nallocs.load();
+    int64_t start = do_now_ns();
+    func.invoke(self, global, ::std::move(stack));
+    return { do_now_ns() - start, s_nallocs.load() - nallocs };
+  }
+
+Result
+do_run_benchmark(const Options& opts, const Benchmark& bench)
+  {
+    Simple_Script code;
+    code.reload_string(cow_string(bench.name), 0, cow_string(bench.source));
+
+    // Find a number of operations that takes long enough.
+    int64_t nops = 1000;
+    while(do_run_once(code, nops).ns < opts.min_time_ms * 1000000) {
+      if(nops >= INT64_C(1) << 40)
+        break;
+      nops *= 2;
+    }
+
+    // Take the minimum of all measurements, which is the least disturbed one.
+    Sample best = { INT64_MAX, 0 };
+    Sample best_setup = { INT64_MAX, 0 };
+    for(int64_t k = 0;  k != opts.repeat;  ++k) {
+      auto sample = do_run_once(code, nops);
+      if(sample.ns < best.ns)
+        best = sample;
+
+      sample = do_run_once(code, 0);
+      if(sample.ns < best_setup.ns)
+        best_setup = sample;
+    }
+
+    Result res;
+    res.name = cow_string(bench.name);
+    res.ns_per_op = static_cast<double>(::rocket::max(best.ns - best_setup.ns, INT64_C(0))) /
+                    static_cast<double>(nops);
+    res.allocs_per_op = (static_cast<double>(best.nallocs) -
+                         static_cast<double>(best_setup.nallocs)) / static_cast<double>(nops);
+    return res;
+  }
+
+cow_vector<Result>
+do_load_baseline(const char* path)
+  {
+    ::rocket::unique_posix_file fp(::fopen(path, "r"), ::fclose);
+    if(!fp)
+      ASTERIA_THROW("Could not open baseline file '$1'\n"
+                    "[`fopen()` failed: $2]",
+                    path, format_errno(errno));
+
+    // Read results line by line. Comments and malformed lines are ignored.
+    cow_vector<Result> results;
+    char line[1024];
+    while(::fgets(line, sizeof(line), fp)) {
+      if(line[0] == '#')
+        continue;
+
+      char name[256];
+      double ns_per_op, allocs_per_op;
+      if(::sscanf(line, "%255s %lf %lf", name, &ns_per_op, &allocs_per_op) != 3)
+        continue;
+
+      results.push_back({ cow_string(name), ns_per_op, allocs_per_op });
+    }
+    return results;
+  }
+
+}  // namespace
+
+void*
+operator new(size_t cb)
+  {
+    auto ptr = ::std::malloc(cb);
+    if(!ptr)
+      throw ::std::bad_alloc();
+
+    s_nallocs.fetch_add(1U);
+    return ptr;
+  }
+
+void
+operator delete(void* ptr)
+  noexcept
+  {
+    ::std::free(ptr);
+  }
+
+void
+operator delete(void* ptr, size_t)
+  noexcept
+  {
+    ::std::free(ptr);
+  }
+
+int
+main(int argc, char** argv)
+  try {
+    auto opts = do_parse_command_line(argc, argv);
+
+    cow_vector<Result> baseline;
+    if(opts.baseline)
+      baseline = do_load_baseline(opts.baseline->c_str());
+
+    if(baseline.empty())
+      ::printf("# name\tns/op\tallocs/op\n");
+    else
+      ::printf("# name\tns/op\tallocs/op\tbase_ns/op\tbase_allocs/op\tchange%%\tstatus\n");
+
+    bool regressed = false;
+    for(const auto& bench : s_benchmarks) {
+      if(!do_is_selected(opts, bench.name))
+        continue;
+
+      auto res = do_run_benchmark(opts, bench);
+      ::printf("%s\t%.3f\t%.3f", res.name.c_str(), res.ns_per_op, res.allocs_per_op);
+
+      // Compare this result with the baseline, if any.
+      auto qbase = ::std::find_if(baseline.begin(), baseline.end(),
+                           [&](const Result& r) { return r.name == res.name;  });
+      if(qbase != baseline.end()) {
+        double change = (res.ns_per_op / qbase->ns_per_op - 1) * 100;
+        bool worse = (change > opts.threshold) ||
+                     (res.allocs_per_op > qbase->allocs_per_op * (1 + opts.threshold / 100) + 0.01);
+        ::printf("\t%.3f\t%.3f\t%+.1f\t%s", qbase->ns_per_op, qbase->allocs_per_op, change,
+                 worse ? "regressed" : "ok");
+        regressed |= worse;
+      }
+      ::printf("\n");
+      ::fflush(stdout);
+    }
+    return regressed;
+  }
+  catch(exception& stdex) {
+    ::fprintf(stderr, "! error: %s\n", stdex.what());
+    return 2;
+  }
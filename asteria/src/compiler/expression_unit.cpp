@@ -61,9 +61,12 @@ generate_code(cow_vector<AIR_Node>& code, const Compiler_Options& opts,
           // Look for the name in the current context.
           qref = qctx->get_named_reference_opt(altr.name);
           if(qref) {
-            // A reference declared later has been found. Record the context depth for
-            // later lookups.
-            AIR_Node::S_push_local_reference xnode = { altr.sloc, depth, altr.name };
+            // A reference declared later has been found. Record the context depth and
+            // its slot for later lookups.
+            size_t slot = qctx->get_named_reference_slot(altr.name);
+            ROCKET_ASSERT(slot != SIZE_MAX);
+            AIR_Node::S_push_local_reference xnode = { altr.sloc, depth, altr.name,
+                                                       static_cast<uint32_t>(slot) };
             code.emplace_back(::std::move(xnode));
             return code;
           }
@@ -199,7 +199,7 @@ generate_code(cow_vector<AIR_Node>& code, cow_vector<phsh_string>* names_opt,
             // If no initializer is provided, no further initialization is required.
             for(size_t k = bpos;  k < epos;  ++k) {
               AIR_Node::S_define_null_variable xnode = { altr.immutable, altr.slocs[i],
-                                                         altr.decls[i][k] };
+                                                         altr.decls[i][k], false };
               code.emplace_back(::std::move(xnode));
             }
           }
@@ -209,7 +209,7 @@ generate_code(cow_vector<AIR_Node>& code, cow_vector<phsh_string>* names_opt,
 
             // Push uninitialized variables from left to right.
             for(size_t k = bpos;  k < epos;  ++k) {
-              AIR_Node::S_declare_variable xnode = { altr.slocs[i], altr.decls[i][k] };
+              AIR_Node::S_declare_variable xnode = { altr.slocs[i], altr.decls[i][k], false };
               code.emplace_back(::std::move(xnode));
             }
 
@@ -244,7 +244,7 @@ generate_code(cow_vector<AIR_Node>& code, cow_vector<phsh_string>* names_opt,
         do_user_declare(names_opt, ctx, altr.name);
 
         // Declare the function, which is effectively an immutable variable.
-        AIR_Node::S_declare_variable xnode_decl = { altr.sloc, altr.name };
+        AIR_Node::S_declare_variable xnode_decl = { altr.sloc, altr.name, false };
         code.emplace_back(::std::move(xnode_decl));
 
         // Generate code
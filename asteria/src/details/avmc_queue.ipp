@@ -132,12 +132,16 @@ struct Header
           delete this->sp_syms->syms_opt;
       }
 
+    Executor*
+    get_executor()
+      const noexcept
+      { return this->has_vtbl ? this->vtbl->executor : this->executor;  }
+
     AIR_Status
     execute(Executive_Context& ctx)
       const
       {
-        return (this->has_vtbl ? this->vtbl->executor : this->executor)(
-                                         ctx, this->uparam(), this->sparam());
+        return this->get_executor()(ctx, this->uparam(), this->sparam());
       }
 
     void
@@ -156,6 +160,11 @@ struct Header
         this->sp_syms->syms_opt = syms_opt.release();
       }
 
+    const Symbols*
+    get_symbols_opt()
+      const noexcept
+      { return this->has_syms ? this->sp_syms->syms_opt : nullptr;  }
+
     ASTERIA_INCOMPLET(Runtime_Error)
     void
     push_symbols(Runtime_Error& except)
@@ -12,6 +12,7 @@ struct Bucket
   {
     Bucket* next;  // the next bucket in the [non-circular] list
     Bucket* prev;  // the previous bucket in the [circular] list
+    size_t slot;  // index in the order of insertion
     union { phsh_string kstor[1];  };  // initialized iff `prev` is non-null
     union { Reference vstor[1];  };  // initialized iff `prev` is non-null
 
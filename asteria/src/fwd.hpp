@@ -159,9 +159,11 @@ class Simple_Script;
 
 // Low-level data structures
 class Variable_HashSet;
+class Variable_List;
 class Reference_Dictionary;
 class Reference_Stack;
 class AVMC_Queue;
+class AVMC_Native;
 
 // Runtime
 enum AIR_Status : uint8_t;
@@ -182,6 +184,10 @@ class Random_Engine;
 class Loader_Lock;
 class Variadic_Arguer;
 class Instantiated_Function;
+class Sampling_Frame;
+class Sampling_Profiler;
+class Node_Counters;
+class Global_Snapshot;
 class AIR_Node;
 class Backtrace_Frame;
 class Argument_Reader;
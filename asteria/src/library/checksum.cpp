@@ -1343,6 +1343,14 @@ std_checksum_sha256(V_string data)
     return do_hash_bytes<SHA256_Hasher>(data);
   }
 
+V_string
+std_checksum_sha256(const void* data, size_t size)
+  {
+    SHA256_Hasher h;
+    h.update(data, size);
+    return h.finish();
+  }
+
 V_string
 std_checksum_sha256_file(V_string path)
   {
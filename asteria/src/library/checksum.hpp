@@ -114,6 +114,11 @@ std_checksum_SHA256();
 V_string
 std_checksum_sha256(V_string data);
 
+// This hashes bytes in place, e.g. those of a mapped file. It is not exposed to
+// scripts.
+V_string
+std_checksum_sha256(const void* data, size_t size);
+
 // `std.checksum.sha256_file`
 V_string
 std_checksum_sha256_file(V_string path);
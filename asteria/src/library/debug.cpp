@@ -4,6 +4,8 @@
 #include "../precompiled.hpp"
 #include "debug.hpp"
 #include "../runtime/argument_reader.hpp"
+#include "../runtime/global_context.hpp"
+#include "../runtime/node_counters.hpp"
 #include "../utils.hpp"
 
 namespace asteria {
@@ -21,6 +23,29 @@ do_write_stderr_common(::rocket::tinyfmt_str&& fmt)
     return static_cast<int64_t>(nput);
   }
 
+V_array
+do_make_node_counters(const Node_Counters& ncount)
+  {
+    V_array result;
+    for(const auto& r : ncount.collect()) {
+      V_object rec;
+      rec.try_emplace(sref("name"),
+        V_string(
+          r.name  // kind of nodes
+        ));
+      rec.try_emplace(sref("count"),
+        V_integer(
+          static_cast<int64_t>(r.count)  // number of executions
+        ));
+      rec.try_emplace(sref("cycles"),
+        V_integer(
+          static_cast<int64_t>(r.cycles)  // excluding nested nodes
+        ));
+      result.emplace_back(::std::move(rec));
+    }
+    return result;
+  }
+
 }  // namespace
 
 Opt_integer
@@ -54,6 +79,40 @@ std_debug_dump(Value value, Opt_integer indent)
     return do_write_stderr_common(::std::move(fmt));
   }
 
+void
+std_debug_node_counters_start(Global_Context& global)
+  {
+    // Reset counters if they exist, so results are not mixed.
+    auto qncount = global.get_node_counters_opt();
+    if(qncount)
+      qncount->clear();
+    else
+      global.set_node_counters(::rocket::make_refcnt<Node_Counters>());
+  }
+
+Opt_array
+std_debug_node_counters_stop(Global_Context& global)
+  {
+    auto qncount = global.get_node_counters_opt();
+    if(!qncount)
+      return nullopt;
+
+    // Collect results before the counters are destroyed.
+    auto result = do_make_node_counters(*qncount);
+    global.set_node_counters(rcptr<Node_Counters>());
+    return ::std::move(result);
+  }
+
+Opt_array
+std_debug_node_counters_get(Global_Context& global)
+  {
+    auto qncount = global.get_node_counters_opt();
+    if(!qncount)
+      return nullopt;
+
+    return do_make_node_counters(*qncount);
+  }
+
 void
 create_bindings_debug(V_object& result, API_Version /*version*/)
   {
@@ -83,6 +142,33 @@ create_bindings_debug(V_object& result, API_Version /*version*/)
                     std_debug_dump, value, indent);
       }
       ASTERIA_BINDING_END);
+
+    result.insert_or_assign(sref("node_counters_start"),
+      ASTERIA_BINDING_BEGIN("std.debug.node_counters_start", self, global, reader) {
+        reader.start_overload();
+        if(reader.end_overload())
+          ASTERIA_BINDING_RETURN_MOVE(self,
+                    std_debug_node_counters_start, global);
+      }
+      ASTERIA_BINDING_END);
+
+    result.insert_or_assign(sref("node_counters_stop"),
+      ASTERIA_BINDING_BEGIN("std.debug.node_counters_stop", self, global, reader) {
+        reader.start_overload();
+        if(reader.end_overload())
+          ASTERIA_BINDING_RETURN_MOVE(self,
+                    std_debug_node_counters_stop, global);
+      }
+      ASTERIA_BINDING_END);
+
+    result.insert_or_assign(sref("node_counters_get"),
+      ASTERIA_BINDING_BEGIN("std.debug.node_counters_get", self, global, reader) {
+        reader.start_overload();
+        if(reader.end_overload())
+          ASTERIA_BINDING_RETURN_MOVE(self,
+                    std_debug_node_counters_get, global);
+      }
+      ASTERIA_BINDING_END);
   }
 
 }  // namespace asteria
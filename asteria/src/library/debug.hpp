@@ -16,6 +16,18 @@ std_debug_logf(V_string templ, cow_vector<Value> values);
 Opt_integer
 std_debug_dump(Value value, Opt_integer indent);
 
+// `std.debug.node_counters_start`
+void
+std_debug_node_counters_start(Global_Context& global);
+
+// `std.debug.node_counters_stop`
+Opt_array
+std_debug_node_counters_stop(Global_Context& global);
+
+// `std.debug.node_counters_get`
+Opt_array
+std_debug_node_counters_get(Global_Context& global);
+
 // Create an object that is to be referenced as `std.debug`.
 void
 create_bindings_debug(V_object& result, API_Version version);
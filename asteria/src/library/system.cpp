@@ -343,6 +343,50 @@ std_system_gc_collect(Global_Context& global, Opt_integer generation_limit)
     return static_cast<int64_t>(nvars);
   }
 
+V_array
+std_system_gc_stats(Global_Context& global)
+  {
+    V_array result;
+    auto gcoll = global.genius_collector();
+    for(auto gc_gen : { gc_generation_newest, gc_generation_middle, gc_generation_oldest }) {
+      const auto& stats = gcoll->get_collector(gc_gen).get_stats();
+
+      // Convert statistics of this generation to an `object`.
+      // Times are converted from nanoseconds to milliseconds.
+      V_object obj;
+      obj.try_emplace(sref("n_coll"),
+        V_integer(
+          stats.collections  // number of collections
+        ));
+      obj.try_emplace(sref("t_total"),
+        V_real(
+          static_cast<double>(stats.pause_total) / 1000'000.0  // total time of collections
+        ));
+      obj.try_emplace(sref("t_max"),
+        V_real(
+          static_cast<double>(stats.pause_max) / 1000'000.0  // time of the longest collection
+        ));
+      obj.try_emplace(sref("n_scan"),
+        V_integer(
+          stats.scanned  // number of variables examined
+        ));
+      obj.try_emplace(sref("n_free"),
+        V_integer(
+          stats.collected  // number of variables collected
+        ));
+      obj.try_emplace(sref("n_prom"),
+        V_integer(
+          stats.promoted  // number of variables moved to the next generation
+        ));
+      obj.try_emplace(sref("n_reuse"),
+        V_integer(
+          stats.pool_hits  // number of variables allocated from the pool
+        ));
+      result.emplace_back(::std::move(obj));
+    }
+    return result;
+  }
+
 Opt_string
 std_system_env_get_variable(V_string name)
   {
@@ -575,6 +619,15 @@ create_bindings_system(V_object& result, API_Version /*version*/)
       }
       ASTERIA_BINDING_END);
 
+    result.insert_or_assign(sref("gc_stats"),
+      ASTERIA_BINDING_BEGIN("std.system.gc_stats", self, global, reader) {
+        reader.start_overload();
+        if(reader.end_overload())
+          ASTERIA_BINDING_RETURN_MOVE(self,
+                    std_system_gc_stats, global);
+      }
+      ASTERIA_BINDING_END);
+
     result.insert_or_assign(sref("env_get_variable"),
       ASTERIA_BINDING_BEGIN("std.system.env_get_variable", self, global, reader) {
         V_string name;
@@ -24,6 +24,10 @@ std_system_gc_set_threshold(Global_Context& global, V_integer generation, V_inte
 V_integer
 std_system_gc_collect(Global_Context& global, Opt_integer generation_limit);
 
+// `std.system.gc_stats`
+V_array
+std_system_gc_stats(Global_Context& global);
+
 // `std.system.env_get_variable`
 Opt_string
 std_system_env_get_variable(V_string name);
@@ -0,0 +1,362 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "../precompiled.hpp"
+#include "avmc_native.hpp"
+#include "../runtime/runtime_error.hpp"
+#include "../runtime/sampling_profiler.hpp"
+#include "../runtime/enums.hpp"
+#include "../utils.hpp"
+
+#if defined(ASTERIA_ENABLE_JIT) && defined(__x86_64__) && defined(__linux__)
+#  define ASTERIA_JIT_X86_64_SYSV  1
+#  include <sys/mman.h>
+#  include <sched.h>  // ::sched_yield()
+extern "C" void __register_frame(void* eh_frame);
+#endif
+
+namespace asteria {
+namespace {
+
+#ifdef ASTERIA_JIT_X86_64_SYSV
+
+using Header = details_avmc_queue::Header;
+using Bytes = cow_vector<uint8_t>;
+
+void
+do_emit(Bytes& code, ::std::initializer_list<uint8_t> bytes)
+  {
+    code.append(bytes.begin(), bytes.end());
+  }
+
+template<typename IntT>
+void
+do_emit_int(Bytes& code, IntT value)
+  {
+    uint8_t bytes[sizeof(value)];
+    ::std::memcpy(bytes, &value, sizeof(value));
+    code.append(bytes, bytes + sizeof(value));
+  }
+
+void
+do_emit_align(Bytes& code, size_t align)
+  {
+    while(code.size() % align)
+      code.emplace_back(0);
+  }
+
+// The entry function has the signature
+//   AIR_Status (Executive_Context& ctx, const Header** qnode)
+// which saves `ctx` in RBX and `qnode` in R12, then calls the executor of each node
+// in order, until one returns a status other than `air_status_next`. The header of
+// the current node is stored into `*qnode` so symbols can be attached to exceptions.
+// Executors are called with
+//   AIR_Status (Executive_Context& ctx, Uparam uparam, const void* sparam)
+// and `Uparam` is passed in a general-purpose register.
+
+// N.B. The unwind information below must match these instructions.
+constexpr uint8_t s_prologue[] =
+  {
+    0x53,                     // push rbx
+    0x41, 0x54,               // push r12
+    0x48, 0x83, 0xEC, 0x08,   // sub rsp, 8
+    0x48, 0x89, 0xFB,         // mov rbx, rdi
+    0x49, 0x89, 0xF4,         // mov r12, rsi
+  };
+
+constexpr uint8_t s_epilogue[] =
+  {
+    0x48, 0x83, 0xC4, 0x08,   // add rsp, 8
+    0x41, 0x5C,               // pop r12
+    0x5B,                     // pop rbx
+    0xC3,                     // ret
+  };
+
+void
+do_emit_node(Bytes& code, cow_vector<size_t>& exits, const Header* qnode)
+  {
+    // movabs rax, qnode
+    // mov [r12], rax
+    // mov rdi, rbx
+    // mov rsi, [rax]
+    do_emit(code, { 0x48, 0xB8 });
+    do_emit_int(code, reinterpret_cast<uintptr_t>(qnode));
+    do_emit(code, { 0x49, 0x89, 0x04, 0x24 });
+    do_emit(code, { 0x48, 0x89, 0xDF });
+    do_emit(code, { 0x48, 0x8B, 0x30 });
+
+    // lea rdx, [rax + sparam]
+    auto off = static_cast<const char*>(qnode->sparam()) - reinterpret_cast<const char*>(qnode);
+    ROCKET_ASSERT((off > 0) && (off < 128));
+    do_emit(code, { 0x48, 0x8D, 0x50, static_cast<uint8_t>(off) });
+
+    if(qnode->has_vtbl) {
+      // The executor of a non-trivial node never changes.
+      // movabs rcx, executor
+      // call rcx
+      do_emit(code, { 0x48, 0xB9 });
+      do_emit_int(code, reinterpret_cast<uintptr_t>(qnode->vtbl->executor));
+      do_emit(code, { 0xFF, 0xD1 });
+    }
+    else {
+      // A trivial node may be rewritten in place, so load the executor every time.
+      // call [rax + 8]
+      static_assert(offsetof(Header, executor) == 8, "");
+      do_emit(code, { 0xFF, 0x50, 0x08 });
+    }
+
+    // test al, al
+    // jnz <epilogue>
+    do_emit(code, { 0x84, 0xC0 });
+    do_emit(code, { 0x0F, 0x85 });
+    exits.emplace_back(code.size());
+    do_emit_int(code, int32_t());
+  }
+
+void
+do_emit_eh_frame(Bytes& code, uintptr_t pc_begin, size_t pc_range)
+  {
+    // Append a CIE and an FDE in the format of `.eh_frame`, so exceptions can be
+    // propagated through native code. Executors are only called after the
+    // prologue, where all frames look the same, so the FDE covers everything.
+    size_t cie_off = code.size();
+    do_emit_int(code, uint32_t());  // length
+    do_emit_int(code, uint32_t());  // CIE ID
+    do_emit(code, { 1, 'z', 'R', 0 });  // version, augmentation
+    do_emit(code, { 1, 0x78, 16 });  // code align, data align (-8), return address
+    do_emit(code, { 1, 0x00 });  // augmentation data: DW_EH_PE_absptr
+    do_emit(code, { 0x0C, 7, 8 });  // DW_CFA_def_cfa: RSP + 8
+    do_emit(code, { 0x90, 1 });  // DW_CFA_offset: RIP at CFA - 8
+    do_emit_align(code, 8);
+    auto cie_len = static_cast<uint32_t>(code.size() - cie_off - 4);
+    ::std::memcpy(code.mut_data() + cie_off, &cie_len, 4);
+
+    size_t fde_off = code.size();
+    do_emit_int(code, uint32_t());  // length
+    do_emit_int(code, static_cast<uint32_t>(code.size() - cie_off));  // CIE pointer
+    do_emit_int(code, pc_begin);
+    do_emit_int(code, static_cast<uint64_t>(pc_range));
+    do_emit(code, { 0 });  // augmentation data: none
+    do_emit(code, { 0x0E, 32 });  // DW_CFA_def_cfa_offset: RSP + 32
+    do_emit(code, { 0x83, 2 });  // DW_CFA_offset: RBX at CFA - 16
+    do_emit(code, { 0x8C, 3 });  // DW_CFA_offset: R12 at CFA - 24
+    do_emit_align(code, 8);
+    auto fde_len = static_cast<uint32_t>(code.size() - fde_off - 4);
+    ::std::memcpy(code.mut_data() + fde_off, &fde_len, 4);
+
+    // Terminate the list.
+    do_emit_int(code, uint32_t());
+  }
+
+// Native code is allocated in pages from a region that is reserved once, and
+// unwind information is registered once for the whole region, as registration
+// and especially deregistration get slow with many objects. Free pages are kept
+// in lists by the number of pages, linked by their indices.
+// These are trivial, so they are still usable when threads exit after `main()`.
+constexpr size_t region_pages_max = 262144;  // 1 GiB with 4 KiB pages
+constexpr size_t native_pages_max = 16;
+
+bool s_lock;
+char* s_region;
+size_t s_page_size;
+size_t s_bump;
+uint32_t* s_free_next;
+uint32_t s_free_head[native_pages_max + 1];  // zero means empty
+
+void
+do_lock()
+  noexcept
+  {
+    while(__atomic_exchange_n(&s_lock, true, __ATOMIC_ACQUIRE))
+      ::sched_yield();
+  }
+
+void
+do_unlock()
+  noexcept
+  {
+    __atomic_store_n(&s_lock, false, __ATOMIC_RELEASE);
+  }
+
+bool
+do_reserve_region()
+  noexcept
+  {
+    if(s_region)
+      return true;
+
+    // Reserve address space without committing memory. Pages are made
+    // accessible when they are allocated.
+    size_t page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    void* base = ::mmap(nullptr, page_size * region_pages_max, PROT_NONE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if(base == MAP_FAILED)
+      return false;
+
+    auto next = static_cast<uint32_t*>(::calloc(region_pages_max, sizeof(uint32_t)));
+    if(!next) {
+      ::munmap(base, page_size * region_pages_max);
+      return false;
+    }
+
+    // Register unwind information, which is never released.
+    Bytes eh_frame;
+    do_emit_eh_frame(eh_frame, reinterpret_cast<uintptr_t>(base),
+                     page_size * region_pages_max);
+    auto eh_copy = ::malloc(eh_frame.size());
+    if(!eh_copy) {
+      ::free(next);
+      ::munmap(base, page_size * region_pages_max);
+      return false;
+    }
+    ::std::memcpy(eh_copy, eh_frame.data(), eh_frame.size());
+    __register_frame(eh_copy);
+
+    s_page_size = page_size;
+    s_free_next = next;
+    s_region = static_cast<char*>(base);
+    return true;
+  }
+
+char*
+do_allocate_pages(size_t& npages, size_t nbytes)
+  noexcept
+  {
+    char* pages = nullptr;
+
+    do_lock();
+    if(do_reserve_region()) {
+      // Code that is too large is not translated.
+      npages = (nbytes + s_page_size - 1) / s_page_size;
+      if(npages > native_pages_max) {
+        do_unlock();
+        return nullptr;
+      }
+
+      // Reuse free pages if any. Indices are biased by one.
+      if(uint32_t index = s_free_head[npages]) {
+        s_free_head[npages] = s_free_next[index - 1];
+        pages = s_region + (index - 1) * s_page_size;
+      }
+      else if(region_pages_max - s_bump >= npages) {
+        pages = s_region + s_bump * s_page_size;
+        s_bump += npages;
+      }
+    }
+    do_unlock();
+    return pages;
+  }
+
+void
+do_free_pages(char* pages, size_t npages)
+  noexcept
+  {
+    // Release memory, and make the pages inaccessible again.
+    ::mmap(pages, npages * s_page_size, PROT_NONE,
+           MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+
+    auto index = static_cast<uint32_t>(static_cast<size_t>(pages - s_region) / s_page_size);
+    do_lock();
+    s_free_next[index] = s_free_head[npages];
+    s_free_head[npages] = index + 1;
+    do_unlock();
+  }
+
+#endif  // ASTERIA_JIT_X86_64_SYSV
+
+}  // namespace
+
+AVMC_Native::
+~AVMC_Native()
+  {
+#ifdef ASTERIA_JIT_X86_64_SYSV
+    if(this->m_base)
+      do_free_pages(static_cast<char*>(this->m_base), this->m_npages);
+#endif
+  }
+
+uptr<AVMC_Native>
+AVMC_Native::
+translate_opt(const Header* bptr, size_t nhdrs)
+  {
+#ifdef ASTERIA_JIT_X86_64_SYSV
+    // Generate code for each node. Conditional jumps to the epilogue are resolved
+    // at the end.
+    Bytes code;
+    cow_vector<size_t> exits;
+    code.append(::std::begin(s_prologue), ::std::end(s_prologue));
+
+    auto next = bptr;
+    const auto eptr = bptr + nhdrs;
+    while(ROCKET_EXPECT(next != eptr)) {
+      auto qnode = next;
+      next += qnode->total_size_in_headers();
+      do_emit_node(code, exits, qnode);
+    }
+
+    // xor eax, eax
+    do_emit(code, { 0x31, 0xC0 });
+    size_t epilogue = code.size();
+    code.append(::std::begin(s_epilogue), ::std::end(s_epilogue));
+
+    for(size_t off : exits) {
+      auto rel = static_cast<int32_t>(epilogue - (off + 4));
+      ::std::memcpy(code.mut_data() + off, &rel, 4);
+    }
+
+    // Allocate pages, which no other thread accesses until they are freed.
+    size_t npages;
+    char* base = do_allocate_pages(npages, code.size());
+    if(!base)
+      return nullptr;
+
+    // Copy code, then make the pages executable.
+    size_t size = npages * s_page_size;
+    if(::mprotect(base, size, PROT_READ | PROT_WRITE) != 0) {
+      do_free_pages(base, npages);
+      return nullptr;
+    }
+    ::std::memcpy(base, code.data(), code.size());
+    if(::mprotect(base, size, PROT_READ | PROT_EXEC) != 0) {
+      do_free_pages(base, npages);
+      return nullptr;
+    }
+
+    uptr<AVMC_Native> native(new AVMC_Native);
+    native->m_base = base;
+    native->m_npages = npages;
+    return native;
+#else
+    // Native code generation is not enabled.
+    (void)bptr;
+    (void)nhdrs;
+    return nullptr;
+#endif
+  }
+
+AIR_Status
+AVMC_Native::
+execute(Executive_Context& ctx)
+  const
+  {
+    Sampling_Frame frame(ctx);
+
+    // This is the same as `AVMC_Queue::execute()`, except that the current node is
+    // tracked by native code, and samples are only taken after it returns.
+    ASTERIA_RUNTIME_TRY {
+      auto entry = reinterpret_cast<Entry*>(this->m_base);
+      auto status = entry(ctx, frame.node_ptr());
+
+      if(ROCKET_UNEXPECT(Sampling_Profiler::is_sample_pending()))
+        Sampling_Profiler::take_sample(ctx.global());
+      return status;
+    }
+    ASTERIA_RUNTIME_CATCH(Runtime_Error& except) {
+      auto qnode = frame.get_node_opt();
+      if(qnode)
+        qnode->push_symbols(except);
+      throw;
+    }
+  }
+
+}  // namespace asteria
@@ -0,0 +1,47 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_LLDS_AVMC_NATIVE_HPP_
+#define ASTERIA_LLDS_AVMC_NATIVE_HPP_
+
+#include "../fwd.hpp"
+#include "avmc_queue.hpp"
+
+namespace asteria {
+
+// This is native code that has been translated from an AVMC queue. Each node is
+// translated into a call to its executor function, so the dispatch loop of the
+// interpreter is eliminated. Nodes are referenced, not copied, so the source nodes
+// shall not be moved or destroyed before this object.
+class AVMC_Native
+  {
+  private:
+    using Header  = details_avmc_queue::Header;
+    using Entry   = AIR_Status (Executive_Context& ctx, const Header** qnode);
+
+    void* m_base = nullptr;  // beginning of executable pages
+    size_t m_npages = 0;  // number of pages
+
+  private:
+    AVMC_Native()
+      noexcept
+      { }
+
+  public:
+    ASTERIA_NONCOPYABLE_DESTRUCTOR(AVMC_Native);
+
+    // Translate a sequence of nodes. If the JIT is disabled or not supported on
+    // this target, a null pointer is returned.
+    static
+    uptr<AVMC_Native>
+    translate_opt(const Header* bptr, size_t nhdrs);
+
+    // These are interfaces called by the runtime.
+    AIR_Status
+    execute(Executive_Context& ctx)
+      const;
+  };
+
+}  // namespace asteria
+
+#endif
@@ -3,13 +3,47 @@
 
 #include "../precompiled.hpp"
 #include "avmc_queue.hpp"
+#include "avmc_native.hpp"
 #include "../runtime/air_node.hpp"
 #include "../runtime/variable_callback.hpp"
 #include "../runtime/runtime_error.hpp"
+#include "../runtime/sampling_profiler.hpp"
+#include "../runtime/node_counters.hpp"
 #include "../runtime/enums.hpp"
 #include "../utils.hpp"
 
 namespace asteria {
+namespace {
+
+// This is the number of executions after which a queue is translated into native
+// code. If the JIT is forced, queues are translated before their first executions.
+#ifdef ASTERIA_JIT_FORCE
+constexpr uint32_t jit_threshold = 0;
+#else
+constexpr uint32_t jit_threshold = 16;
+#endif
+
+AIR_Status
+do_execute_counted(Node_Counters& ncount, const details_avmc_queue::Header* qnode,
+                   Executive_Context& ctx)
+  {
+    // Measure this node. Cycles of nested nodes are excluded.
+    uint64_t saved = ncount.enter();
+    uint64_t start = Node_Counters::read_clock();
+    AIR_Status status;
+
+    try {
+      status = qnode->execute(ctx);
+    }
+    catch(...) {
+      ncount.leave(saved, qnode->get_executor(), Node_Counters::read_clock() - start);
+      throw;
+    }
+    ncount.leave(saved, qnode->get_executor(), Node_Counters::read_clock() - start);
+    return status;
+  }
+
+}  // namespace
 
 void
 AVMC_Queue::
@@ -31,6 +65,15 @@ do_destroy_nodes()
     this->m_used = 0xDEADBEEF;
   }
 
+void
+AVMC_Queue::
+do_destroy_native()
+  noexcept
+  {
+    delete this->m_native;
+    this->m_native = nullptr;
+  }
+
 void
 AVMC_Queue::
 do_reallocate(uint32_t nadd)
@@ -45,6 +88,12 @@ do_reallocate(uint32_t nadd)
     uint32_t rsrv = this->m_used + nadd;
     auto bptr = static_cast<Header*>(::operator new(rsrv * sizeof(Header)));
 
+    // Native code refers to nodes in the old block. The queue may be translated
+    // again after it is modified.
+    if(this->m_native)
+      this->do_destroy_native();
+    this->m_nexec = 0;
+
     // Perform a bitwise copy of all contents of the old block.
     // This copies all existent headers and trivial data.
     // Note that the size is unchanged.
@@ -162,27 +211,74 @@ do_append_nontrivial(const Vtable* vtbl, Uparam uparam, opt<Symbols>&& syms_opt,
     return *this;
   }
 
+void
+AVMC_Queue::
+rewrite_trivial(const void* sparam, Uparam up, Executor* executor)
+  noexcept
+  {
+    // Locate the header. It is followed by symbols, and then `sparam`.
+    auto qnode = const_cast<Header*>(static_cast<const Header*>(sparam) - 2);
+    ROCKET_ASSERT(qnode->has_syms);
+    ROCKET_ASSERT(!qnode->has_vtbl);
+    ROCKET_ASSERT(qnode->sparam() == sparam);
+
+    // Overwrite user-defined bits, then the executor.
+    ::std::memcpy(qnode->up_stor.p8, up.p8, sizeof(up.p8));
+    qnode->executor = executor;
+  }
+
 AIR_Status
 AVMC_Queue::
 execute(Executive_Context& ctx)
   const
   {
+    // Keep the counters alive, as they may be uninstalled by a nested call.
+    const auto qncount = ctx.global().get_node_counters_opt();
+
+#ifdef ASTERIA_ENABLE_JIT
+    // Translate this queue when it gets hot. The counter stops once translation
+    // has been attempted, so this happens at most once, even if it fails.
+    if(ROCKET_UNEXPECT(this->m_nexec <= jit_threshold))
+      if(this->m_nexec++ == jit_threshold)
+        this->m_native = AVMC_Native::translate_opt(this->m_bptr, this->m_used).release();
+
+    // Native code is bypassed when nodes are being counted.
+    if(this->m_native && !qncount)
+      return this->m_native->execute(ctx);
+#endif
+
     auto next = this->m_bptr;
     const auto eptr = this->m_bptr + this->m_used;
-    while(ROCKET_EXPECT(next != eptr)) {
-      auto qnode = next;
-      next += qnode->total_size_in_headers();
+    Sampling_Frame frame(ctx);
+
+    // The handler is set up once for the whole queue, so the loop below does
+    // nothing but calling executors one by one.
+    ASTERIA_RUNTIME_TRY {
+      while(ROCKET_EXPECT(next != eptr)) {
+        auto qnode = next;
+        next += qnode->total_size_in_headers();
+        frame.set_node(qnode);
+
+        // Call the executor function for this node.
+        AIR_Status status;
+        if(ROCKET_EXPECT(!qncount))
+          status = qnode->execute(ctx);
+        else
+          status = do_execute_counted(*qncount, qnode, ctx);
+
+        // Take a sample if the profiling timer has fired.
+        if(ROCKET_UNEXPECT(Sampling_Profiler::is_sample_pending()))
+          Sampling_Profiler::take_sample(ctx.global());
 
-      // Call the executor function for this node.
-      ASTERIA_RUNTIME_TRY {
-        auto status = qnode->execute(ctx);
         if(ROCKET_UNEXPECT(status != air_status_next))
           return status;
       }
-      ASTERIA_RUNTIME_CATCH(Runtime_Error& except) {
-        qnode->push_symbols(except);
-        throw;
-      }
+    }
+    ASTERIA_RUNTIME_CATCH(Runtime_Error& except) {
+      auto qnode = frame.get_node_opt();
+      ROCKET_ASSERT(qnode);
+      qnode->push_symbols(except);
+      throw;
     }
     return air_status_next;
   }
@@ -27,6 +27,12 @@ class AVMC_Queue
     uint32_t m_rsrv = 0;  // size of raw storage, in number of `Header`s [!]
     uint32_t m_used = 0;  // size of used storage, in number of `Header`s [!]
 
+    // This queue is translated into native code after it has been executed for a
+    // few times. Translation is attempted only once, and native code is never
+    // replaced, as it may be running in outer frames.
+    mutable uint32_t m_nexec = 0;  // saturated after translation
+    mutable AVMC_Native* m_native = nullptr;  // owned
+
   public:
     explicit constexpr
     AVMC_Queue()
@@ -47,6 +53,10 @@ class AVMC_Queue
     do_destroy_nodes()
       noexcept;
 
+    void
+    do_destroy_native()
+      noexcept;
+
     void
     do_reallocate(uint32_t nadd);
 
@@ -96,6 +106,9 @@ class AVMC_Queue
   public:
     ~AVMC_Queue()
       {
+        if(this->m_native)
+          this->do_destroy_native();
+
         if(this->m_used)
           this->do_destroy_nodes();
 
@@ -116,10 +129,14 @@ class AVMC_Queue
     clear()
       noexcept
       {
+        if(this->m_native)
+          this->do_destroy_native();
+
         if(this->m_used)
           this->do_destroy_nodes();
 
         // Clean invalid data up.
+        this->m_nexec = 0;
         this->m_used = 0;
         return *this;
       }
@@ -139,6 +156,8 @@ class AVMC_Queue
         ::std::swap(this->m_bptr, other.m_bptr);
         ::std::swap(this->m_rsrv, other.m_rsrv);
         ::std::swap(this->m_used, other.m_used);
+        ::std::swap(this->m_nexec, other.m_nexec);
+        ::std::swap(this->m_native, other.m_native);
         return *this;
       }
 
@@ -211,6 +230,14 @@ class AVMC_Queue
       { return this->do_append_chk<execT, qvenumT>(up, ::std::move(syms),
                               ::std::forward<XSparamT>(xsp));  }
 
+    // Modify a node in place. `sparam` shall be the argument that has been passed to
+    // its executor. The node shall have symbols and shall not have a vtable.
+    // This allows a node to specialize itself according to data observed at run time.
+    static
+    void
+    rewrite_trivial(const void* sparam, Uparam up, Executor* executor)
+      noexcept;
+
     // These are interfaces called by the runtime.
     AIR_Status
     execute(Executive_Context& ctx)
@@ -8,6 +8,52 @@
 
 namespace asteria {
 
+Reference_Dictionary::
+Reference_Dictionary(const Reference_Dictionary& other)
+  {
+    if(!other.m_bptr)
+      return;
+
+    // Allocate a table of the same size, so buckets can be copied into the same
+    // positions without probing, and slots are preserved.
+    size_t nbkt = static_cast<size_t>(other.m_eptr - other.m_bptr);
+    auto bptr = static_cast<Bucket*>(::operator new(nbkt * sizeof(Bucket) +
+                                                    nbkt / 2 * sizeof(Bucket*)));
+    auto eptr = bptr + nbkt;
+
+    ::std::for_each(bptr, eptr, [&](Bucket& r) { r.prev = nullptr;  });
+    ::std::fill_n(reinterpret_cast<Bucket**>(eptr), nbkt / 2, nullptr);
+    this->m_bptr = bptr;
+    this->m_eptr = eptr;
+
+    // Copy buckets from the last one, so they are linked in the same order.
+    try {
+      auto sbkt = other.m_head ? other.m_head->prev : nullptr;
+      while(ROCKET_EXPECT(sbkt)) {
+        ROCKET_ASSERT(*sbkt);
+        auto qbkt = bptr + (sbkt - other.m_bptr);
+
+        // Copy the reference first, which might throw an exception.
+        ::rocket::construct_at(qbkt->vstor, sbkt->vstor[0]);
+        ::rocket::construct_at(qbkt->kstor, sbkt->kstor[0]);
+        this->do_list_attach(qbkt);
+        qbkt->slot = sbkt->slot;
+        this->do_slots()[qbkt->slot] = qbkt;
+
+        // Process the previous bucket.
+        sbkt = (sbkt == other.m_head) ? nullptr : sbkt->prev;
+      }
+    }
+    catch(...) {
+      if(this->m_head)
+        this->do_destroy_buckets();
+      ::operator delete(this->m_bptr);
+      throw;
+    }
+    this->m_size = other.m_size;
+    this->m_nslot = other.m_nslot;
+  }
+
 void
 Reference_Dictionary::
 do_destroy_buckets()
@@ -88,6 +134,8 @@ do_xrelocate_but(Bucket* qxcld)
         ::rocket::destroy_at(sbkt->kstor);
         ::rocket::construct_at(qbkt->vstor, ::std::move(sbkt->vstor[0]));
         ::rocket::destroy_at(sbkt->vstor);
+        qbkt->slot = sbkt->slot;
+        this->do_slots()[qbkt->slot] = qbkt;
 
         // Keep probing until an empty bucket is found.
         return false;
@@ -130,15 +178,26 @@ do_rehash(size_t nbkt)
   {
     ROCKET_ASSERT(nbkt / 2 > this->m_size);
 
-    // Allocate a new table.
-    if(nbkt > PTRDIFF_MAX / sizeof(Bucket))
+    // Allocate a new table, followed by slots.
+    if(nbkt > PTRDIFF_MAX / (sizeof(Bucket) + sizeof(Bucket*)))
       throw ::std::bad_array_new_length();
 
-    auto bptr = static_cast<Bucket*>(::operator new(nbkt * sizeof(Bucket)));
+    auto bptr = static_cast<Bucket*>(::operator new(nbkt * sizeof(Bucket) +
+                                                    nbkt / 2 * sizeof(Bucket*)));
     auto eptr = bptr + nbkt;
 
+    // Renumber slots in the order of insertion, so those of erased names are
+    // reused. Names that precede all erased ones keep their slots.
+    size_t nslot = 0;
+    for(size_t k = 0;  k != this->m_nslot;  ++k)
+      if(auto qbkt = this->do_slots()[k])
+        qbkt->slot = nslot++;
+    ROCKET_ASSERT(nslot == this->m_size);
+    this->m_nslot = nslot;
+
     // Initialize an empty table.
     ::std::for_each(bptr, eptr, [&](Bucket& r) { r.prev = nullptr;  });
+    ::std::fill_n(reinterpret_cast<Bucket**>(eptr), nbkt / 2, nullptr);
     auto bold = ::std::exchange(this->m_bptr, bptr);
     this->m_eptr = eptr;
 
@@ -165,6 +224,8 @@ do_rehash(size_t nbkt)
       ::rocket::destroy_at(sbkt->kstor);
       ::rocket::construct_at(qbkt->vstor, ::std::move(sbkt->vstor[0]));
       ::rocket::destroy_at(sbkt->vstor);
+      qbkt->slot = sbkt->slot;
+      this->do_slots()[qbkt->slot] = qbkt;
 
       // Process the next bucket.
       sbkt = sbkt->next;
@@ -185,6 +246,11 @@ do_attach(Bucket* qbkt, const phsh_string& name)
     ::rocket::construct_at(qbkt->vstor, Reference::S_uninit());
     ROCKET_ASSERT(*qbkt);
     this->m_size++;
+
+    // Assign a new slot.
+    ROCKET_ASSERT(this->m_nslot < static_cast<size_t>(this->m_eptr - this->m_bptr) / 2);
+    qbkt->slot = this->m_nslot++;
+    this->do_slots()[qbkt->slot] = qbkt;
   }
 
 void
@@ -195,6 +261,7 @@ do_detach(Bucket* qbkt)
     // Destroy the old name and reference, then detach the bucket.
     this->m_size--;
     ROCKET_ASSERT(*qbkt);
+    this->do_slots()[qbkt->slot] = nullptr;
     ::rocket::destroy_at(qbkt->kstor);
     ::rocket::destroy_at(qbkt->vstor);
     this->do_list_detach(qbkt);
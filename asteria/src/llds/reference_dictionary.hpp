@@ -19,6 +19,7 @@ class Reference_Dictionary
     Bucket* m_eptr = nullptr;  // end of bucket storage
     Bucket* m_head = nullptr;  // the first initialized bucket
     size_t m_size = 0;         // number of initialized buckets
+    size_t m_nslot = 0;        // number of slots that have been assigned
 
   public:
     explicit constexpr
@@ -26,16 +27,32 @@ class Reference_Dictionary
       noexcept
       { }
 
+    Reference_Dictionary(const Reference_Dictionary& other);
+
     Reference_Dictionary(Reference_Dictionary&& other)
       noexcept
       { this->swap(other);  }
 
+    Reference_Dictionary&
+    operator=(const Reference_Dictionary& other)
+      {
+        Reference_Dictionary(other).swap(*this);
+        return *this;
+      }
+
     Reference_Dictionary&
     operator=(Reference_Dictionary&& other)
       noexcept
       { return this->swap(other);  }
 
   private:
+    // Slots follow buckets in the same block of memory. There are half as many
+    // slots as buckets.
+    Bucket**
+    do_slots()
+      const noexcept
+      { return reinterpret_cast<Bucket**>(this->m_eptr);  }
+
     void
     do_destroy_buckets()
       noexcept;
@@ -65,6 +82,7 @@ class Reference_Dictionary
       noexcept;
 
     // This function is primarily used to reallocate a larger table.
+    // Slots are renumbered, with those of erased names removed.
     void
     do_rehash(size_t nbkt);
 
@@ -114,6 +132,7 @@ class Reference_Dictionary
         // Clean invalid data up.
         this->m_head = nullptr;
         this->m_size = 0;
+        this->m_nslot = 0;
         return *this;
       }
 
@@ -125,6 +144,7 @@ class Reference_Dictionary
         ::std::swap(this->m_eptr, other.m_eptr);
         ::std::swap(this->m_head, other.m_head);
         ::std::swap(this->m_size, other.m_size);
+        ::std::swap(this->m_nslot, other.m_nslot);
         return *this;
       }
 
@@ -146,13 +166,50 @@ class Reference_Dictionary
         return qbkt->vstor;
       }
 
+    // Each name is assigned a slot when it is inserted. Slots are numbered in the
+    // order of insertion, so a context that declares the same names in the same
+    // order has the same slots. This allows names to be resolved at compile time.
+    // If `slot` doesn't denote `name`, a normal lookup is performed.
+    const Reference*
+    find_opt(const phsh_string& name, size_t slot)
+      const noexcept
+      {
+        if(ROCKET_EXPECT(slot < this->m_nslot)) {
+          auto qbkt = this->do_slots()[slot];
+          if(ROCKET_EXPECT(qbkt && (qbkt->kstor[0] == name)))
+            return qbkt->vstor;
+        }
+        return this->find_opt(name);
+      }
+
+    // Get the slot of a name. If the name is not found, `SIZE_MAX` is returned.
+    size_t
+    find_slot(const phsh_string& name)
+      const noexcept
+      {
+        // Be advised that `do_xprobe()` shall not be called when the
+        // table has not been allocated.
+        if(!this->m_bptr)
+          return SIZE_MAX;
+
+        // Find the bucket for the name.
+        auto qbkt = this->do_xprobe(name);
+        if(!*qbkt)
+          return SIZE_MAX;
+
+        ROCKET_ASSERT(qbkt->kstor[0].rdhash() == name.rdhash());
+        return qbkt->slot;
+      }
+
     Reference&
     open(const phsh_string& name)
       {
         // Reserve more room by rehashing if the load factor would
-        // exceed 0.5.
+        // exceed 0.5. Slots of erased names are counted until they
+        // are compacted by rehashing, so the table only grows if
+        // most slots are in use.
         auto nbkt = static_cast<size_t>(this->m_eptr - this->m_bptr);
-        if(ROCKET_UNEXPECT(this->m_size >= nbkt / 2))
+        if(ROCKET_UNEXPECT(this->m_nslot >= nbkt / 2))
           // Ensure the number of buckets is an odd number.
           this->do_rehash(this->m_size * 3 | 17);
 
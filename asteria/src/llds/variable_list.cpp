@@ -0,0 +1,29 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "../precompiled.hpp"
+#include "variable_list.hpp"
+#include "../runtime/variable_callback.hpp"
+#include "../utils.hpp"
+
+namespace asteria {
+
+Variable_Callback&
+Variable_List::
+enumerate_variables(Variable_Callback& callback)
+  const
+  {
+    auto qvar = ::std::addressof(this->m_head);
+    while(ROCKET_EXPECT(*qvar)) {
+      // Enumerate a child variable.
+      auto var = qvar->get();
+      callback.process(*qvar);
+
+      // If the variable has been erased, `*qvar` is the next one now.
+      if(qvar->get() == var)
+        qvar = ::std::addressof(var->m_gc_next);
+    }
+    return callback;
+  }
+
+}  // namespace asteria
@@ -0,0 +1,183 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_LLDS_VARIABLE_LIST_HPP_
+#define ASTERIA_LLDS_VARIABLE_LIST_HPP_
+
+#include "../fwd.hpp"
+#include "../runtime/variable.hpp"
+
+namespace asteria {
+
+// This is a doubly linked list whose links are embedded in variables, so a
+// variable can be in at most one list at a time. The list owns a reference to
+// each of its variables, which is stored in the previous one.
+// Variables can be visited in passes, where each variable is visited once in
+// each pass, even if others are inserted or erased between visits.
+class Variable_List
+  {
+  private:
+    rcptr<Variable> m_head;
+    Variable* m_tail = nullptr;
+    size_t m_size = 0;
+    uint32_t m_pass = 1;  // visited variables are marked with this value
+
+  public:
+    explicit
+    Variable_List()
+      noexcept
+      { }
+
+    Variable_List(const Variable_List&)
+      = delete;
+
+    Variable_List&
+    operator=(const Variable_List&)
+      = delete;
+
+  private:
+    // This returns the pointer that owns `var`.
+    rcptr<Variable>&
+    do_owner_of(Variable* var)
+      noexcept
+      { return var->m_gc_prev ? var->m_gc_prev->m_gc_next : this->m_head;  }
+
+    // These functions do not change the reference count of `var`.
+    void
+    do_link_front(rcptr<Variable>&& var)
+      noexcept
+      {
+        ROCKET_ASSERT(var->m_gc_list == nullptr);
+        var->m_gc_list = this;
+        var->m_gc_prev = nullptr;
+        if(this->m_head)
+          this->m_head->m_gc_prev = var.get();
+        else
+          this->m_tail = var.get();
+        var->m_gc_next = ::std::move(this->m_head);
+        this->m_head = ::std::move(var);
+        this->m_size++;
+      }
+
+    void
+    do_link_back(rcptr<Variable>&& var)
+      noexcept
+      {
+        ROCKET_ASSERT(var->m_gc_list == nullptr);
+        var->m_gc_list = this;
+        var->m_gc_prev = this->m_tail;
+        this->m_tail = var.get();
+        this->do_owner_of(var.get()) = ::std::move(var);
+        this->m_size++;
+      }
+
+    rcptr<Variable>
+    do_unlink(Variable* var)
+      noexcept
+      {
+        ROCKET_ASSERT(var->m_gc_list == this);
+        auto& owner = this->do_owner_of(var);
+        auto self = ::std::move(owner);
+        owner = ::std::move(var->m_gc_next);
+        if(owner)
+          owner->m_gc_prev = var->m_gc_prev;
+        else
+          this->m_tail = var->m_gc_prev;
+        var->m_gc_list = nullptr;
+        var->m_gc_prev = nullptr;
+        this->m_size--;
+        return self;
+      }
+
+  public:
+    ~Variable_List()
+      {
+        this->clear();
+      }
+
+    bool
+    empty()
+      const noexcept
+      { return this->m_head == nullptr;  }
+
+    size_t
+    size()
+      const noexcept
+      { return this->m_size;  }
+
+    Variable_List&
+    clear()
+      noexcept
+      {
+        // Variables are released one by one, as recursion might overflow the
+        // stack.
+        while(this->m_head)
+          this->do_unlink(this->m_head.get());
+        return *this;
+      }
+
+    bool
+    has(const rcptr<Variable>& var)
+      const noexcept
+      { return var->m_gc_list == this;  }
+
+    // If `var` is in a list already, this function fails. Otherwise it is
+    // inserted at the front, as one that has not been visited.
+    bool
+    insert(const rcptr<Variable>& var)
+      noexcept
+      {
+        if(var->m_gc_list)
+          return false;
+
+        var->m_gc_pass = this->m_pass - 1;
+        this->do_link_front(rcptr<Variable>(var));
+        return true;
+      }
+
+    bool
+    erase(const rcptr<Variable>& var)
+      noexcept
+      {
+        if(var->m_gc_list != this)
+          return false;
+
+        // It cannot be unique because `var` outlives this function.
+        this->do_unlink(var.get());
+        return true;
+      }
+
+    // Get a variable that has not been visited in this pass, and mark it as
+    // visited. The result is invalidated when this list is modified. If all
+    // variables have been visited, a null pointer is returned.
+    // Unvisited variables are kept at the front, and visited ones at the back.
+    const rcptr<Variable>*
+    visit_next_opt()
+      noexcept
+      {
+        auto var = this->m_head.get();
+        if(!var || (var->m_gc_pass == this->m_pass))
+          return nullptr;
+
+        var->m_gc_pass = this->m_pass;
+        this->do_link_back(this->do_unlink(var));
+        return ::std::addressof(this->do_owner_of(var));
+      }
+
+    // Start a new pass, where no variable has been visited.
+    Variable_List&
+    start_pass()
+      noexcept
+      {
+        this->m_pass++;
+        return *this;
+      }
+
+    Variable_Callback&
+    enumerate_variables(Variable_Callback& callback)
+      const;
+  };
+
+}  // namespace asteria
+
+#endif
@@ -3,7 +3,10 @@
 
 #include "../precompiled.hpp"
 #include "fwd.hpp"
+#include "../runtime/global_context.hpp"
+#include "../runtime/sampling_profiler.hpp"
 #include "rocket/tinybuf_file.hpp"
+#include "rocket/tinyfmt_file.hpp"
 
 namespace asteria {
 namespace {
@@ -175,6 +178,101 @@ struct Command_heredoc
       }
   };
 
+struct Command_profile
+  final
+  : public Command
+  {
+    const char*
+    cmd()
+      const noexcept override
+      { return "profile";  }
+
+    const char*
+    oneline()
+      const noexcept override
+      { return "start or stop the sampling profiler";  }
+
+    const char*
+    description()
+      const noexcept override
+      { return
+//       1         2         3         4         5         6         7      |
+// 4567890123456789012345678901234567890123456789012345678901234567890123456|
+"""""""""""""""""""""""""""""""""""""""""""""""""""""""""" R"'''''''''''''''(
+* profile start [INTERVAL]
+
+  Start sampling snippets that are executed afterwards. INTERVAL is the
+  sampling interval in microseconds of CPU time. If INTERVAL is absent, it
+  defaults to 10000 (that is, 100 samples per second).
+
+* profile stop [PATH]
+
+  Stop sampling, then write all samples as folded stacks, which can be fed
+  to flame graph tools. If PATH is specified, samples are written to the
+  file designated by PATH. Otherwise, they are written to standard error.
+)'''''''''''''''" """"""""""""""""""""""""""""""""""""""""""""""""""""""""+1;
+// 4567890123456789012345678901234567890123456789012345678901234567890123456|
+//       1         2         3         4         5         6         7      |
+      }
+
+    void
+    handle(cow_string&& args)
+      const override
+      {
+        // Split the action from its argument.
+        size_t pos = args.find_first_of(" \t");
+        auto action = args.substr(0, pos);
+        pos = args.find_first_not_of(pos, " \t");
+        auto param = args.substr(::rocket::min(pos, args.size()));
+
+        auto prof = repl_global.get_profiler_opt();
+        if(action == "start") {
+          unsigned interval = 10000;
+          if(param.size()) {
+            const char* bptr = param.data();
+            const char* eptr = bptr + param.size();
+            ::rocket::ascii_numget numg;
+            if(!numg.get(interval, bptr, eptr) || (bptr != eptr) || (interval == 0))
+              return repl_printf("! invalid sampling interval: %s\n", param.c_str());
+          }
+
+          if(!prof) {
+            prof = ::rocket::make_refcnt<Sampling_Profiler>();
+            repl_global.set_profiler(prof);
+          }
+          else if(prof->is_running())
+            return repl_printf("! profiler is already running\n");
+
+          prof->clear();
+          prof->start(interval);
+          return repl_printf("* profiler started (interval = %u us)\n", interval);
+        }
+
+        if(action == "stop") {
+          if(!prof || !prof->is_running())
+            return repl_printf("! profiler is not running\n");
+
+          prof->stop();
+
+          if(param.empty()) {
+            ::rocket::tinyfmt_str fmt;
+            prof->print_folded(fmt);
+            repl_printf("%s", fmt.c_str());
+          }
+          else {
+            ::rocket::tinyfmt_file fmt(param.safe_c_str(),
+                                       ::rocket::tinybuf::open_write |
+                                       ::rocket::tinybuf::open_truncate);
+            prof->print_folded(fmt);
+          }
+          return repl_printf("* profiler stopped (%llu samples)\n",
+                             static_cast<unsigned long long>(prof->count_samples()));
+        }
+
+        repl_printf("! `profile` requires `start` or `stop`\n");
+      }
+  };
+
 struct Command_source
   final
   : public Command
@@ -264,6 +362,7 @@ const uptr<const Command> s_commands[] =
     ::rocket::make_unique<Command_exit>(),
     ::rocket::make_unique<Command_help>(),
     ::rocket::make_unique<Command_heredoc>(),
+    ::rocket::make_unique<Command_profile>(),
     ::rocket::make_unique<Command_source>(),
   };
 
@@ -26,6 +26,7 @@ struct Command_Line
     bool verbose = false;
     bool interactive = false;
     Compiler_Options opts;
+    cow_string cache_dir;
 
     // non-options
     cow_string path;
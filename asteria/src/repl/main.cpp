@@ -19,6 +19,7 @@ do_print_help_and_exit(const char* self)
 """""""""""""""""""""""""""""""""""""""""""""""""""""""""" R"'''''''''''''''(
 Usage: %s [OPTIONS] [[--] FILE [ARGUMENTS]...]
 
+  -C DIR  cache compiled scripts in directory DIR
   -h      show help message then exit
   -I      suppress interactive mode [default = auto]
   -i      force interactive mode [default = auto]
@@ -90,6 +91,7 @@ do_parse_command_line(int argc, char** argv)
     opt<bool> verbose;
     opt<bool> interactive;
     opt<int8_t> optimize;
+    opt<cow_string> cache_dir;
 
     opt<cow_string> path;
     cow_vector<cow_string> args;
@@ -105,9 +107,13 @@ do_parse_command_line(int argc, char** argv)
 
     // Parse command-line options.
     int ch;
-    while((ch = ::getopt(argc, argv, "+hIiO::Vv")) != -1) {
+    while((ch = ::getopt(argc, argv, "+C:hIiO::Vv")) != -1) {
       // Identify a single option.
       switch(ch) {
+        case 'C':
+          cache_dir = cow_string(optarg);
+          continue;
+
         case 'h':
           help = true;
           continue;
@@ -185,6 +191,10 @@ do_parse_command_line(int argc, char** argv)
     if(optimize)
       repl_cmdline.opts.optimization_level = *optimize;
 
+    // Compiled scripts are not cached by default.
+    if(cache_dir)
+      repl_cmdline.cache_dir = ::std::move(*cache_dir);
+
     // These arguments are always overwritten.
     repl_cmdline.path = path.move_value_or(sref("-"));
     repl_cmdline.args = ::std::move(args);
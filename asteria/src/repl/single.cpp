@@ -14,6 +14,7 @@ load_and_execute_single_noreturn()
   try {
     // Prepare the parser.
     repl_script.set_options(repl_cmdline.opts);
+    repl_script.set_cache_directory(repl_cmdline.cache_dir);
 
     // Load and parse the script.
     try {
@@ -68,10 +68,34 @@ class Abstract_Context
         return qref;
       }
 
+    // Look for a name with a slot that has been resolved at compile time.
+    const Reference*
+    get_named_reference_opt(const phsh_string& name, size_t slot)
+      {
+        auto qref = this->m_named_refs.find_opt(name, slot);
+        if(ROCKET_UNEXPECT(!qref))
+          qref = this->do_lazy_lookup_opt(name);
+        return qref;
+      }
+
+    size_t
+    get_named_reference_slot(const phsh_string& name)
+      const noexcept
+      { return this->m_named_refs.find_slot(name);  }
+
     Reference&
     open_named_reference(const phsh_string& name)
       { return this->m_named_refs.open(name);  }
 
+    const Reference_Dictionary&
+    get_named_references()
+      const noexcept
+      { return this->m_named_refs;  }
+
+    Abstract_Context&
+    set_named_references(const Reference_Dictionary& refs)
+      { return this->m_named_refs = refs, *this;  }
+
     Abstract_Context&
     clear_named_references()
       noexcept
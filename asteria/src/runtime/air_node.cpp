@@ -15,6 +15,7 @@
 #include "ptc_arguments.hpp"
 #include "loader_lock.hpp"
 #include "air_optimizer.hpp"
+#include "node_counters.hpp"
 #include "../compiler/token_stream.hpp"
 #include "../compiler/statement_sequence.hpp"
 #include "../compiler/statement.hpp"
@@ -66,8 +67,7 @@ do_rebind_return_opt(bool dirty, XNodeT&& xnode)
 bool
 do_solidify_nodes(AVMC_Queue& queue, const cow_vector<AIR_Node>& code)
   {
-    bool r = ::rocket::all_of(code,
-        [&](const AIR_Node& node) { return node.solidify(queue);  });
+    bool r = AIR_Node::solidify_all(queue, code);
     queue.shrink_to_fit();
     return r;
   }
@@ -122,6 +122,44 @@ do_execute_block(const AVMC_Queue& queue, Executive_Context& ctx)
     return status;
   }
 
+template<typename TraitsT>
+cow_string
+do_traits_name()
+  {
+    // Extract the name of `TraitsT` from the signature of this function, which
+    // looks like `... [with TraitsT = asteria::{anonymous}::AIR_Traits_xxx; ...]`
+    // with GCC, or `... [TraitsT = asteria::(anonymous namespace)::AIR_Traits_xxx]`
+    // with Clang.
+    const cow_string sig = sref(__PRETTY_FUNCTION__);
+    size_t bpos = sig.find("TraitsT = ");
+    if(bpos == cow_string::npos)
+      return sref("[unknown]");
+
+    bpos += 10;
+    size_t epos = sig.find_first_of(bpos, ";]");
+    cow_string name = sig.substr(bpos, epos - bpos);
+
+    // Remove namespaces and prefixes for brevity.
+    for(auto prefix : { "asteria::", "{anonymous}::", "(anonymous namespace)::", "std::",
+                        "AIR_Traits_" }) {
+      size_t pos;
+      while((pos = name.find(prefix)) != cow_string::npos)
+        name.erase(pos, ::std::strlen(prefix));
+    }
+    return name;
+  }
+
+template<typename TraitsT, AVMC_Queue::Executor execT>
+inline
+void
+do_name_executor()
+  {
+    // Each executor is named only once.
+    static const bool s_named = (Node_Counters::name_executor(execT,
+                                                  do_traits_name<TraitsT>), true);
+    (void)s_named;
+  }
+
 // These are user-defined parameter types for AVMC nodes.
 // The `enumerate_variables()` callback is optional.
 
@@ -248,6 +286,21 @@ struct Sparam_defer
       }
   };
 
+struct Sparam_inline
+  {
+    Source_Location sloc;
+    rcptr<Variadic_Arguer> zvarg;
+    cow_vector<phsh_string> params;
+    AVMC_Queue queue;
+
+    Variable_Callback&
+    enumerate_variables(Variable_Callback& callback)
+      const
+      {
+        return this->queue.enumerate_variables(callback);
+      }
+  };
+
 // These are traits for individual AIR node types.
 // Each traits struct must contain the `execute()` function, and optionally,
 // these functions: `make_uparam()`, `make_sparam()`, `make_symbols()`.
@@ -290,9 +343,18 @@ struct AIR_Traits_execute_block
 
 struct AIR_Traits_declare_variable
   {
-    // `Uparam` is unused.
+    // `Uparam` is `untracked`.
     // `Sparam` is the source location and name;
 
+    static
+    AVMC_Queue::Uparam
+    make_uparam(bool& /*reachable*/, const AIR_Node::S_declare_variable& altr)
+      {
+        AVMC_Queue::Uparam up;
+        up.p8[0] = altr.untracked;
+        return up;
+      }
+
     static
     Sparam_sloc_name
     make_sparam(bool& /*reachable*/, const AIR_Node::S_declare_variable& altr)
@@ -314,14 +376,14 @@ struct AIR_Traits_declare_variable
 
     static
     AIR_Status
-    execute(Executive_Context& ctx, const Sparam_sloc_name& sp)
+    execute(Executive_Context& ctx, const AVMC_Queue::Uparam& up, const Sparam_sloc_name& sp)
       {
         const auto qhooks = ctx.global().get_hooks_opt();
         const auto gcoll = ctx.global().genius_collector();
 
         // Allocate an uninitialized variable.
         // Inject the variable into the current context.
-        auto var = gcoll->create_variable();
+        auto var = up.p8[0] ? gcoll->create_untracked_variable() : gcoll->create_variable();
         Reference::S_variable xref = { ::std::move(var) };
         ctx.open_named_reference(sp.name) = xref;  // it'll be used later so don't move!
         if(qhooks)
@@ -649,6 +711,9 @@ struct AIR_Traits_for_each_statement
         ROCKET_ASSERT(status == air_status_next);
         mapped = ::std::move(ctx_for.stack().mut_back());
 
+        // The range has been converted to a temporary value, which can't be modified
+        // by the loop body. Elements are bound as temporary values directly, rather
+        // than references with modifiers, which would be copied in each iteration.
         const auto range = mapped.dereference_readonly();
         switch(weaken_enum(range.type())) {
           case type_null:
@@ -662,8 +727,8 @@ struct AIR_Traits_for_each_statement
               vkey->initialize(i, true);
 
               // Set the mapped reference.
-              Reference::M_array_index xmod = { i };
-              mapped.zoom_in(::std::move(xmod));
+              Reference::S_temporary xelem = { arr[static_cast<size_t>(i)] };
+              mapped = ::std::move(xelem);
 
               // Execute the loop body.
               status = do_execute_block(sp.queue_body, ctx_for);
@@ -674,9 +739,6 @@ struct AIR_Traits_for_each_statement
               if(::rocket::is_none_of(status, { air_status_next, air_status_continue_unspec,
                                                 air_status_continue_for }))
                 return status;
-
-              // Restore the mapped reference.
-              mapped.zoom_out();
             }
             return air_status_next;
           }
@@ -688,8 +750,8 @@ struct AIR_Traits_for_each_statement
               vkey->initialize(it->first.rdstr(), true);
 
               // Set the mapped reference.
-              Reference::M_object_key xmod = { it->first.rdstr() };
-              mapped.zoom_in(::std::move(xmod));
+              Reference::S_temporary xelem = { it->second };
+              mapped = ::std::move(xelem);
 
               // Execute the loop body.
               status = do_execute_block(sp.queue_body, ctx_for);
@@ -700,9 +762,6 @@ struct AIR_Traits_for_each_statement
               if(::rocket::is_none_of(status, { air_status_next, air_status_continue_unspec,
                                                 air_status_continue_for }))
                 return status;
-
-              // Restore the mapped reference.
-              mapped.zoom_out();
             }
             return air_status_next;
           }
@@ -1114,15 +1173,17 @@ struct AIR_Traits_push_global_reference
 
 struct AIR_Traits_push_local_reference
   {
-    // `Uparam` is the depth.
+    // `Uparam` is the depth and slot.
     // `Sparam` is the source location and name;
 
     static
     AVMC_Queue::Uparam
     make_uparam(bool& /*reachable*/, const AIR_Node::S_push_local_reference& altr)
       {
+        // If the slot doesn't fit, a lookup by name is performed.
         AVMC_Queue::Uparam up;
         up.s32 = altr.depth;
+        up.s16 = static_cast<uint16_t>(::rocket::min(altr.slot, UINT32_C(0xFFFF)));
         return up;
       }
 
@@ -1155,8 +1216,8 @@ struct AIR_Traits_push_local_reference
                              [&](uint32_t) { qctx = qctx->get_parent_opt();  });
         ROCKET_ASSERT(qctx);
 
-        // Look for the name in the context.
-        auto qref = qctx->get_named_reference_opt(sp.name);
+        // Look for the name in the context. Try the slot first.
+        auto qref = qctx->get_named_reference_opt(sp.name, up.s16);
         if(!qref)
           ASTERIA_THROW("Undeclared identifier `$1`", sp.name);
 
@@ -3534,7 +3595,7 @@ struct AIR_Traits_unpack_struct_object
 
 struct AIR_Traits_define_null_variable
   {
-    // `Uparam` is `immutable`.
+    // `Uparam` is `immutable` and `untracked`.
     // `Sparam` is the source location and name.
 
     static
@@ -3543,6 +3604,7 @@ struct AIR_Traits_define_null_variable
       {
         AVMC_Queue::Uparam up;
         up.p8[0] = altr.immutable;
+        up.p8[1] = altr.untracked;
         return up;
       }
 
@@ -3574,7 +3636,7 @@ struct AIR_Traits_define_null_variable
 
         // Allocate an uninitialized variable.
         // Inject the variable into the current context.
-        auto var = gcoll->create_variable();
+        auto var = up.p8[1] ? gcoll->create_untracked_variable() : gcoll->create_variable();
         Reference::S_variable xref = { var };
         ctx.open_named_reference(sp.name) = ::std::move(xref);
 
@@ -3998,805 +4060,3730 @@ struct AIR_Traits_initialize_reference
       }
   };
 
-// These are helper type traits.
-// Depending on the existence of Uparam, Sparam and Symbols, the code will look very
-// different.
+struct AIR_Traits_inline_call
+  {
+    // `Uparam` is `nargs`.
+    // `Sparam` is the source location and the function.
 
-// check for `make_uparam`
-template<typename TraitsT, typename XNodeT, typename = void>
-struct Uparam_of
-  : ::rocket::identity<void>
-  { };
+    static
+    AVMC_Queue::Uparam
+    make_uparam(bool& /*reachable*/, const AIR_Node::S_inline_call& altr)
+      {
+        AVMC_Queue::Uparam up;
+        up.s32 = altr.nargs;
+        return up;
+      }
 
-template<typename TraitsT, typename XNodeT>
-struct Uparam_of<TraitsT, XNodeT, ROCKET_VOID_T(decltype(&TraitsT::make_uparam))>
-  : ::std::decay<decltype(TraitsT::make_uparam(::std::declval<bool&>(),
-                                               ::std::declval<const XNodeT&>()))>
-  { };
+    static
+    Sparam_inline
+    make_sparam(bool& /*reachable*/, const AIR_Node::S_inline_call& altr)
+      {
+        Sparam_inline sp;
+        sp.sloc = altr.sloc;
+        sp.zvarg = ::rocket::make_refcnt<Variadic_Arguer>(altr.sloc_func, cow_string(altr.func));
+        sp.params = altr.params;
+        do_solidify_nodes(sp.queue, altr.code_body);
+        return sp;
+      }
 
-// check for `make_sparam`
-template<typename TraitsT, typename XNodeT, typename = void>
-struct Sparam_of
-  : ::rocket::identity<void>
-  { };
+    static
+    AVMC_Queue::Symbols
+    make_symbols(const AIR_Node::S_inline_call& altr)
+      {
+        AVMC_Queue::Symbols syms;
+        syms.sloc = altr.sloc;
+        return syms;
+      }
 
-template<typename TraitsT, typename XNodeT>
-struct Sparam_of<TraitsT, XNodeT, ROCKET_VOID_T(decltype(&TraitsT::make_sparam))>
-  : ::std::decay<decltype(TraitsT::make_sparam(::std::declval<bool&>(),
-                                               ::std::declval<const XNodeT&>()))>
-  { };
+    static
+    AIR_Status
+    execute(Executive_Context& ctx, const AVMC_Queue::Uparam& up, const Sparam_inline& sp)
+      {
+        const auto sentry = ctx.global().copy_recursion_sentry();
+        const auto qhooks = ctx.global().get_hooks_opt();
 
-// check for `make_symbols`
-template<typename TraitsT, typename XNodeT, typename = void>
-struct Symbols_of
-  : ::rocket::identity<void>
-  { };
+        // Generate a single-step trap before unpacking arguments.
+        if(qhooks)
+          qhooks->on_single_step_trap(sp.sloc);
 
-template<typename TraitsT, typename XNodeT>
-struct Symbols_of<TraitsT, XNodeT, ROCKET_VOID_T(decltype(&TraitsT::make_symbols))>
-  : ::std::decay<decltype(TraitsT::make_symbols(::std::declval<const XNodeT&>()))>
-  { };
+        // Pop arguments off the stack backwards.
+        auto& alt_stack = do_pop_positional_arguments_into_alt_stack(ctx, up.s32);
 
-// executor thunk
-template<typename TraitsT, typename UparamT, typename SparamT>
-struct Executor_of
-  {
-    static
-    AIR_Status
-    thunk(Executive_Context& ctx, AVMC_Queue::Uparam up, const void* sp)
-      { return TraitsT::execute(ctx, UparamT(up), *(const SparamT*)sp);  }
+        // Execute the body on a new function context.
+        // This is the same as `Instantiated_Function::invoke_ptc_aware()`, but no
+        // function object is involved.
+        Reference self = Reference::S_void();
+        Reference_Stack alt_stack_func;
+        Executive_Context ctx_func(Executive_Context::M_function(), ctx.global(), alt_stack,
+                                   alt_stack_func, sp.zvarg, sp.params, ::std::move(self));
+        AIR_Status status;
+
+        ASTERIA_RUNTIME_TRY {
+          status = sp.queue.execute(ctx_func);
+        }
+        ASTERIA_RUNTIME_CATCH(Runtime_Error& except) {
+          ctx_func.on_scope_exit(except);
+          except.push_frame_func(sp.zvarg->sloc(), sp.zvarg->func());
+          throw;
+        }
+        ctx_func.on_scope_exit(status);
+
+        switch(status) {
+          case air_status_next:
+          case air_status_return_void:
+            // Return void if the control flow reached the end of the function.
+            self = Reference::S_void();
+            break;
+
+          case air_status_return_ref:
+            // Return the reference at the top of `alt_stack`.
+            self = ::std::move(alt_stack.mut_back());
+
+            // In case of PTCs, set up source location.
+            if(auto ptca = self.get_ptc_args_opt()) {
+              PTC_Arguments::Caller call = { sp.zvarg->sloc(), sp.zvarg->func() };
+              ptca->set_caller(::std::move(call));
+            }
+            break;
+
+          case air_status_break_unspec:
+          case air_status_break_switch:
+          case air_status_break_while:
+          case air_status_break_for:
+            ASTERIA_THROW("Stray `break` statement\n[jumped from '$1']",
+                          alt_stack.back().as_jump_src());
+
+          case air_status_continue_unspec:
+          case air_status_continue_while:
+          case air_status_continue_for:
+            ASTERIA_THROW("Stray `continue` statement\n[jumped from '$1']",
+                          alt_stack.back().as_jump_src());
+
+          default:
+            ASTERIA_TERMINATE("invalid AIR status code (status `$1`)", status);
+        }
+
+        // Unpack proper tail calls and push the result.
+        self.finish_call(ctx.global());
+        ctx.stack().emplace_back(::std::move(self));
+        return air_status_next;
+      }
   };
 
-template<typename TraitsT, typename UparamT>
-struct Executor_of<TraitsT, UparamT, void>
+// These are fused superinstructions.
+// Each of them replaces a frequent sequence of two nodes, which saves an indirect
+// call and a round trip to the queue driver.
+
+struct S_fused_local_to_prvalue
   {
-    static
-    AIR_Status
-    thunk(Executive_Context& ctx, AVMC_Queue::Uparam up, const void* /*sp*/)
-      { return TraitsT::execute(ctx, UparamT(up));  }
+    const AIR_Node::S_push_local_reference& push;
+    const AIR_Node::S_glvalue_to_prvalue& conv;
   };
 
-template<typename TraitsT, typename SparamT>
-struct Executor_of<TraitsT, void, SparamT>
+struct AIR_Traits_fused_local_to_prvalue
   {
+    // `Uparam` is the depth.
+    // `Sparam` is the source location and name;
+
     static
-    AIR_Status
-    thunk(Executive_Context& ctx, AVMC_Queue::Uparam /*up*/, const void* sp)
-      { return TraitsT::execute(ctx, *(const SparamT*)sp);  }
-  };
+    AVMC_Queue::Uparam
+    make_uparam(bool& reachable, const S_fused_local_to_prvalue& altr)
+      {
+        return AIR_Traits_push_local_reference::make_uparam(reachable, altr.push);
+      }
+
+    static
+    Sparam_sloc_name
+    make_sparam(bool& reachable, const S_fused_local_to_prvalue& altr)
+      {
+        return AIR_Traits_push_local_reference::make_sparam(reachable, altr.push);
+      }
+
+    static
+    AVMC_Queue::Symbols
+    make_symbols(const S_fused_local_to_prvalue& altr)
+      {
+        return AIR_Traits_push_local_reference::make_symbols(altr.push);
+      }
 
-template<typename TraitsT>
-struct Executor_of<TraitsT, void, void>
-  {
     static
     AIR_Status
-    thunk(Executive_Context& ctx, AVMC_Queue::Uparam /*up*/, const void* /*sp*/)
-      { return TraitsT::execute(ctx);  }
+    execute(Executive_Context& ctx, const AVMC_Queue::Uparam& up, const Sparam_sloc_name& sp)
+      {
+        // Push the reference, then convert it to a temporary value.
+        AIR_Traits_push_local_reference::execute(ctx, up, sp);
+        return AIR_Traits_glvalue_to_prvalue::execute(ctx);
+      }
   };
 
-// enumerator thunk
-template<typename SparamT, typename = void>
-struct Enumerator_of
+struct S_fused_immediate_operator
   {
-    static constexpr AVMC_Queue::Enumerator* thunk = nullptr;
+    const AIR_Node::S_push_immediate& push;
+    const AIR_Node::S_apply_operator& oper;
   };
 
-template<typename SparamT>
-struct Enumerator_of<SparamT, ROCKET_VOID_T(decltype(&SparamT::enumerate_variables))>
+inline
+bool
+do_is_fusible_immediate(const Value& value)
+  noexcept
   {
-    static
-    Variable_Callback&
-    thunk(Variable_Callback& callback, AVMC_Queue::Uparam /*up*/, const void* sp)
-      { return static_cast<const SparamT*>(sp)->enumerate_variables(callback);  }
-  };
+    return value.is_integer() && (value.as_integer() >= INT32_MIN)
+                              && (value.as_integer() <= INT32_MAX);
+  }
 
-// Finally...
-template<typename TraitsT, typename XNodeT, typename UparamT, typename SparamT,
-         typename SymbolT>
-struct AVMC_Appender
+template<typename TraitsT, typename FastT>
+struct AIR_Traits_fused_immediate_operator
   {
+    // `Uparam` is `assign` and the RHS operand, which is a 32-bit integer.
+    // `Sparam` is unused.
+
     static
-    bool
-    do_append(AVMC_Queue& queue, const XNodeT& altr)
+    AVMC_Queue::Uparam
+    make_uparam(bool& /*reachable*/, const S_fused_immediate_operator& altr)
       {
-        bool reachable = true;
-        queue.template append<Executor_of<TraitsT, UparamT, SparamT>::thunk,
-                              Enumerator_of<SparamT>::thunk>(
-                              TraitsT::make_symbols(altr),
-                              TraitsT::make_uparam(reachable, altr),
-                              TraitsT::make_sparam(reachable, altr));
-        return reachable;
+        int64_t value = altr.push.value.as_integer();
+        ROCKET_ASSERT((value >= INT32_MIN) && (value <= INT32_MAX));
+
+        AVMC_Queue::Uparam up;
+        up.p8[0] = altr.oper.assign;
+        up.s32 = static_cast<uint32_t>(value);
+        return up;
       }
-  };
 
-template<typename TraitsT, typename XNodeT, typename UparamT, typename SparamT>
-struct AVMC_Appender<TraitsT, XNodeT, UparamT, SparamT, void>
-  {
     static
-    bool
-    do_append(AVMC_Queue& queue, const XNodeT& altr)
+    AVMC_Queue::Symbols
+    make_symbols(const S_fused_immediate_operator& altr)
       {
-        bool reachable = true;
-        queue.template append<Executor_of<TraitsT, UparamT, SparamT>::thunk,
-                              Enumerator_of<SparamT>::thunk>(
-                              TraitsT::make_uparam(reachable, altr),
-                              TraitsT::make_sparam(reachable, altr));
-        return reachable;
+        AVMC_Queue::Symbols syms;
+        syms.sloc = altr.oper.sloc;
+        return syms;
+      }
+
+    static
+    AIR_Status
+    execute(Executive_Context& ctx, const AVMC_Queue::Uparam& up)
+      {
+        int64_t y = static_cast<int32_t>(up.s32);
+
+        // This operator is binary, but the RHS operand is not on the stack.
+        // Try performing the operation on integers in place. This will not throw
+        // exceptions, and may fail on overflows.
+        auto& lhs = up.p8[0] ? ctx.stack().back().dereference_mutable()  // assign
+                             : ctx.stack().mut_back().mutate_into_temporary();
+        if(ROCKET_EXPECT(lhs.is_integer() && FastT::apply(lhs, y)))
+          return air_status_next;
+
+        // Push the RHS operand and take the generic path.
+        // Converting the LHS operand again is a no-op.
+        Reference::S_constant xref = { V_integer(y) };
+        ctx.stack().emplace_back(::std::move(xref));
+        return TraitsT::execute(ctx, up);
       }
   };
 
-template<typename TraitsT, typename XNodeT, typename UparamT, typename SymbolT>
-struct AVMC_Appender<TraitsT, XNodeT, UparamT, void, SymbolT>
+struct Fast_add
   {
     static
     bool
-    do_append(AVMC_Queue& queue, const XNodeT& altr)
+    apply(Value& lhs, int64_t y)
+      noexcept
       {
-        bool reachable = true;
-        queue.template append<Executor_of<TraitsT, UparamT, void>::thunk,
-                              nullptr>(
-                              TraitsT::make_symbols(altr),
-                              TraitsT::make_uparam(reachable, altr));
-        return reachable;
+        auto& x = lhs.open_integer();
+        if((y >= 0) ? (x > INT64_MAX - y) : (x < INT64_MIN - y))
+          return false;
+        x += y;
+        return true;
       }
   };
 
-template<typename TraitsT, typename XNodeT, typename UparamT>
-struct AVMC_Appender<TraitsT, XNodeT, UparamT, void, void>
+struct Fast_sub
   {
     static
     bool
-    do_append(AVMC_Queue& queue, const XNodeT& altr)
+    apply(Value& lhs, int64_t y)
+      noexcept
       {
-        bool reachable = true;
-        queue.template append<Executor_of<TraitsT, UparamT, void>::thunk,
-                              nullptr>(
-                              TraitsT::make_uparam(reachable, altr));
-        return reachable;
+        auto& x = lhs.open_integer();
+        if((y >= 0) ? (x < INT64_MIN + y) : (x > INT64_MAX + y))
+          return false;
+        x -= y;
+        return true;
       }
   };
 
-template<typename TraitsT, typename XNodeT, typename SparamT, typename SymbolT>
-struct AVMC_Appender<TraitsT, XNodeT, void, SparamT, SymbolT>
+template<typename PredT>
+struct Fast_compare
   {
     static
     bool
-    do_append(AVMC_Queue& queue, const XNodeT& altr)
+    apply(Value& lhs, int64_t y)
       {
-        bool reachable = true;
-        queue.template append<Executor_of<TraitsT, void, SparamT>::thunk,
-                              Enumerator_of<SparamT>::thunk>(
-                              TraitsT::make_symbols(altr),
-                              AVMC_Queue::Uparam(),
-                              TraitsT::make_sparam(reachable, altr));
-        return reachable;
+        lhs = PredT()(lhs.as_integer(), y);
+        return true;
       }
   };
 
-template<typename TraitsT, typename XNodeT, typename SparamT>
-struct AVMC_Appender<TraitsT, XNodeT, void, SparamT, void>
+// These are self-specializing (quickening) binary operators.
+// A node starts in the profiling state, where the types of its operands are recorded.
+// If both operands have been of the same type for a few executions and there is a
+// fast path for that type, the node is rewritten into a monomorphic form. Otherwise,
+// or if the guard of the monomorphic form fails, the node is rewritten into the
+// generic form and remains there.
+
+constexpr uint8_t quick_profile_count = 4;
+
+struct Quick_add_integer
   {
+    static constexpr Type type = type_integer;
+
     static
     bool
-    do_append(AVMC_Queue& queue, const XNodeT& altr)
-      {
-        bool reachable = true;
-        queue.template append<Executor_of<TraitsT, void, SparamT>::thunk,
-                              Enumerator_of<SparamT>::thunk>(
-                              AVMC_Queue::Uparam(),
-                              TraitsT::make_sparam(reachable, altr));
-        return reachable;
-      }
+    apply(Value& lhs, const Value& rhs)
+      { return Fast_add::apply(lhs, rhs.as_integer());  }
   };
 
-template<typename TraitsT, typename XNodeT, typename SymbolT>
-struct AVMC_Appender<TraitsT, XNodeT, void, void, SymbolT>
+struct Quick_add_real
   {
+    static constexpr Type type = type_real;
+
     static
     bool
-    do_append(AVMC_Queue& queue, const XNodeT& altr)
-      {
-        bool reachable = true;
-        queue.template append<Executor_of<TraitsT, void, void>::thunk,
-                              nullptr>(
-                              TraitsT::make_symbols(altr),
-                              AVMC_Queue::Uparam());
-        return reachable;
-      }
+    apply(Value& lhs, const Value& rhs)
+      { return lhs.open_real() += rhs.as_real(), true;  }
   };
 
-template<typename TraitsT, typename XNodeT>
-struct AVMC_Appender<TraitsT, XNodeT, void, void, void>
+struct Quick_sub_integer
   {
+    static constexpr Type type = type_integer;
+
     static
     bool
-    do_append(AVMC_Queue& queue, const XNodeT& /*altr*/)
-      {
-        bool reachable = true;
-        queue.template append<Executor_of<TraitsT, void, void>::thunk,
-                              nullptr>(
-                              AVMC_Queue::Uparam());
-        return reachable;
-      }
+    apply(Value& lhs, const Value& rhs)
+      { return Fast_sub::apply(lhs, rhs.as_integer());  }
   };
 
-template<typename TraitsT, typename XNodeT>
-inline
-bool
-do_solidify(AVMC_Queue& queue, const XNodeT& altr)
+struct Quick_sub_real
   {
-    return AVMC_Appender<TraitsT, XNodeT,
-                         typename Uparam_of<TraitsT, XNodeT>::type,
-                         typename Sparam_of<TraitsT, XNodeT>::type,
-                         typename Symbols_of<TraitsT, XNodeT>::type>
-               ::do_append(queue, altr);
-  }
+    static constexpr Type type = type_real;
 
-}  // namespace
+    static
+    bool
+    apply(Value& lhs, const Value& rhs)
+      { return lhs.open_real() -= rhs.as_real(), true;  }
+  };
 
-opt<AIR_Node>
-AIR_Node::
-rebind_opt(Abstract_Context& ctx)
-  const
+struct Quick_mul_integer
   {
-    switch(this->index()) {
-      case index_clear_stack:
-        // There is nothing to rebind.
-        return nullopt;
+    static constexpr Type type = type_integer;
 
-      case index_execute_block: {
-        const auto& altr = this->m_stor.as<index_execute_block>();
+    static
+    bool
+    apply(Value& lhs, const Value& rhs)
+      {
+        auto& x = lhs.open_integer();
+        auto y = rhs.as_integer();
 
-        // Rebind the body.
-        Analytic_Context ctx_body(Analytic_Context::M_plain(), ctx);
-        bool dirty = false;
-        auto bound = altr;
+        // Leave edge cases to the generic path.
+        if((x == INT64_MIN) || (y == INT64_MIN))
+          return false;
 
-        do_rebind_nodes(dirty, bound.code_body, ctx_body);
+        // Check for overflows.
+        if((x != 0) && (y != 0)) {
+          int64_t m = y >> 63;
+          int64_t s = (x ^ m) - m;  // x
+          int64_t u = (y ^ m) - m;  // abs(y)
 
-        return do_rebind_return_opt(dirty, ::std::move(bound));
+          if((s >= 0) ? (s > INT64_MAX / u) : (s < INT64_MIN / u))
+            return false;
+        }
+        x *= y;
+        return true;
       }
+  };
 
-      case index_declare_variable:
-      case index_initialize_variable:
-        // There is nothing to rebind.
-        return nullopt;
+struct Quick_mul_real
+  {
+    static constexpr Type type = type_real;
 
-      case index_if_statement: {
-        const auto& altr = this->m_stor.as<index_if_statement>();
+    static
+    bool
+    apply(Value& lhs, const Value& rhs)
+      { return lhs.open_real() *= rhs.as_real(), true;  }
+  };
 
-        // Rebind both branches.
-        Analytic_Context ctx_body(Analytic_Context::M_plain(), ctx);
-        bool dirty = false;
-        auto bound = altr;
+template<typename PredT>
+struct Quick_compare_integer
+  {
+    static constexpr Type type = type_integer;
 
-        do_rebind_nodes(dirty, bound.code_true, ctx_body);
-        do_rebind_nodes(dirty, bound.code_false, ctx_body);
+    static
+    bool
+    apply(Value& lhs, const Value& rhs)
+      { return lhs = PredT()(lhs.as_integer(), rhs.as_integer()), true;  }
+  };
 
-        return do_rebind_return_opt(dirty, ::std::move(bound));
+template<typename PredT>
+struct Quick_compare_real
+  {
+    static constexpr Type type = type_real;
+
+    static
+    bool
+    apply(Value& lhs, const Value& rhs)
+      {
+        // Unordered operands are handled by the generic path.
+        double x = lhs.as_real();
+        double y = rhs.as_real();
+        if(::std::isunordered(x, y))
+          return false;
+
+        lhs = PredT()(x, y);
+        return true;
       }
+  };
 
-      case index_switch_statement: {
-        const auto& altr = this->m_stor.as<index_switch_statement>();
+template<typename PredT>
+struct Quick_compare_string
+  {
+    static constexpr Type type = type_string;
 
-        // Rebind all clauses.
-        Analytic_Context ctx_body(Analytic_Context::M_plain(), ctx);
-        bool dirty = false;
-        auto bound = altr;
+    static
+    bool
+    apply(Value& lhs, const Value& rhs)
+      {
+        bool res = PredT()(lhs.as_string().compare(rhs.as_string()), 0);
+        lhs = res;
+        return true;
+      }
+  };
 
-        do_rebind_nodes(dirty, bound.code_labels, ctx);  // this is not part of the body!
-        do_rebind_nodes(dirty, bound.code_bodies, ctx_body);
+template<typename TraitsT, typename... QuickT>
+struct AIR_Traits_quick_binary
+  {
+    // `Uparam` is `assign` and the profile.
+    // `up.p8[1]` is the number of executions so far.
+    // `up.p8[2]` is the type of operands that have been observed.
+    // `Sparam` is unused.
 
-        return do_rebind_return_opt(dirty, ::std::move(bound));
+    static
+    AIR_Status
+    execute_generic(Executive_Context& ctx, AVMC_Queue::Uparam up, const void* /*sp*/)
+      {
+        return TraitsT::execute(ctx, up);
       }
 
-      case index_do_while_statement: {
-        const auto& altr = this->m_stor.as<index_do_while_statement>();
+    template<typename XQuickT>
+    static
+    AIR_Status
+    execute_monomorphic(Executive_Context& ctx, AVMC_Queue::Uparam up, const void* sp)
+      {
+        // Check the RHS operand before modifying the stack.
+        const auto& rhs = ctx.stack().back().dereference_readonly();
+        if(ROCKET_UNEXPECT(rhs.type() != XQuickT::type)) {
+          AVMC_Queue::rewrite_trivial(sp, up, execute_generic);
+          return TraitsT::execute(ctx, up);
+        }
 
-        // Rebind the body and the condition.
-        Analytic_Context ctx_body(Analytic_Context::M_plain(), ctx);
-        bool dirty = false;
-        auto bound = altr;
+        // This operator is binary.
+        ctx.stack().pop_back();
+        auto& lhs = up.p8[0] ? ctx.stack().back().dereference_mutable()  // assign
+                             : ctx.stack().mut_back().mutate_into_temporary();
 
-        do_rebind_nodes(dirty, bound.code_body, ctx_body);
-        do_rebind_nodes(dirty, bound.code_cond, ctx);  // this is not part of the body!
+        bool guard = lhs.type() == XQuickT::type;
+        if(ROCKET_EXPECT(guard && XQuickT::apply(lhs, rhs)))
+          return air_status_next;
 
-        return do_rebind_return_opt(dirty, ::std::move(bound));
+        // Push the RHS operand back and take the generic path.
+        // Converting the LHS operand again is a no-op.
+        Reference::S_constant xref = { rhs };
+        ctx.stack().emplace_back(::std::move(xref));
+        if(!guard)
+          AVMC_Queue::rewrite_trivial(sp, up, execute_generic);
+        return TraitsT::execute(ctx, up);
       }
 
-      case index_while_statement: {
-        const auto& altr = this->m_stor.as<index_while_statement>();
+    static
+    AVMC_Queue::Executor*
+    do_select_monomorphic(Type type)
+      noexcept
+      {
+        static constexpr Type s_types[] = { QuickT::type... };
+        static constexpr AVMC_Queue::Executor* s_execs[] = { execute_monomorphic<QuickT>... };
 
-        // Rebind the condition and the body.
-        Analytic_Context ctx_body(Analytic_Context::M_plain(), ctx);
-        bool dirty = false;
-        auto bound = altr;
+        for(size_t k = 0;  k != sizeof...(QuickT);  ++k)
+          if(s_types[k] == type)
+            return s_execs[k];
+        return execute_generic;
+      }
 
-        do_rebind_nodes(dirty, bound.code_cond, ctx);  // this is not part of the body!
-        do_rebind_nodes(dirty, bound.code_body, ctx_body);
+    static
+    AIR_Status
+    execute_profile(Executive_Context& ctx, AVMC_Queue::Uparam up, const void* sp)
+      {
+        // Record the type of operands.
+        const auto& rhs = ctx.stack().back().dereference_readonly();
+        const auto& lhs = ctx.stack().back(1).dereference_readonly();
+        auto type = rhs.type();
+
+        if((lhs.type() != type) || (up.p8[1] && (up.p8[2] != type)))
+          AVMC_Queue::rewrite_trivial(sp, up, execute_generic);
+        else if(++(up.p8[1]) < quick_profile_count) {
+          up.p8[2] = type;
+          AVMC_Queue::rewrite_trivial(sp, up, execute_profile);
+        }
+        else
+          AVMC_Queue::rewrite_trivial(sp, up, do_select_monomorphic(type));
 
-        return do_rebind_return_opt(dirty, ::std::move(bound));
+        // Perform the operation now.
+        return TraitsT::execute(ctx, up);
       }
 
-      case index_for_each_statement: {
-        const auto& altr = this->m_stor.as<index_for_each_statement>();
-
-        // Rebind the range initializer and the body.
-        Analytic_Context ctx_for(Analytic_Context::M_plain(), ctx);
-        Analytic_Context ctx_body(Analytic_Context::M_plain(), ctx_for);
-        bool dirty = false;
-        auto bound = altr;
+    static
+    bool
+    do_name_executors()
+      {
+        // Executors are named after the generic one, with the state appended.
+        Node_Counters::name_executor(execute_generic, do_traits_name<TraitsT>, "generic");
+        Node_Counters::name_executor(execute_profile, do_traits_name<TraitsT>, "profiling");
+        for(Type type : { QuickT::type... })
+          Node_Counters::name_executor(do_select_monomorphic(type), do_traits_name<TraitsT>,
+                                       describe_type(type));
+        return true;
+      }
 
-        do_rebind_nodes(dirty, bound.code_init, ctx_for);
-        do_rebind_nodes(dirty, bound.code_body, ctx_body);
+    static
+    bool
+    do_append(AVMC_Queue& queue, const AIR_Node::S_apply_operator& altr)
+      {
+        static const bool s_named = do_name_executors();
+        (void)s_named;
 
-        return do_rebind_return_opt(dirty, ::std::move(bound));
+        bool reachable = true;
+        auto up = TraitsT::make_uparam(reachable, altr);
+        up.p8[1] = 0;
+        up.p8[2] = 0;
+        queue.template append<execute_profile, nullptr>(TraitsT::make_symbols(altr), up);
+        return reachable;
       }
+  };
 
-      case index_for_statement: {
-        const auto& altr = this->m_stor.as<index_for_statement>();
-
-        // Rebind the initializer, the condition, the loop increment and the body.
-        Analytic_Context ctx_for(Analytic_Context::M_plain(), ctx);
-        Analytic_Context ctx_body(Analytic_Context::M_plain(), ctx_for);
-        bool dirty = false;
-        auto bound = altr;
+template<typename TraitsT, template<typename> class PredT>
+using AIR_Traits_quick_compare = AIR_Traits_quick_binary<TraitsT,
+                                     Quick_compare_integer<PredT<int64_t>>,
+                                     Quick_compare_real<PredT<double>>,
+                                     Quick_compare_string<PredT<int>>>;
+
+// These are helpers for constant folding.
+// Only operations that are known to succeed are folded. Anything that might throw an
+// exception, such as overflows or mismatched types, is left as is, so the error is
+// reported at runtime in the same way.
+
+opt<Value>
+do_fold_unary_opt(Xop xop, const Value& rhs)
+  {
+    Value val = rhs;
+    switch(weaken_enum(xop)) {
+      case xop_pos:
+        return val;
+
+      case xop_neg:
+        if(val.is_integer() && (val.as_integer() != INT64_MIN)) {
+          val.open_integer() = -val.as_integer();
+          return val;
+        }
+        if(val.is_real()) {
+          val.open_real() = -val.as_real();
+          return val;
+        }
+        return nullopt;
 
-        do_rebind_nodes(dirty, bound.code_init, ctx_for);
-        do_rebind_nodes(dirty, bound.code_cond, ctx_for);
-        do_rebind_nodes(dirty, bound.code_step, ctx_for);
-        do_rebind_nodes(dirty, bound.code_body, ctx_body);
+      case xop_notb:
+        if(val.is_boolean()) {
+          val.open_boolean() = !val.as_boolean();
+          return val;
+        }
+        if(val.is_integer()) {
+          val.open_integer() = ~val.as_integer();
+          return val;
+        }
+        return nullopt;
 
-        return do_rebind_return_opt(dirty, ::std::move(bound));
-      }
+      case xop_notl:
+        return Value(!val.test());
 
-      case index_try_statement: {
-        const auto& altr = this->m_stor.as<index_try_statement>();
+      default:
+        return nullopt;
+    }
+  }
 
-        // Rebind the `try` and `catch` clauses.
-        Analytic_Context ctx_body(Analytic_Context::M_plain(), ctx);
-        bool dirty = false;
-        auto bound = altr;
+opt<Value>
+do_fold_binary_opt(Xop xop, const Value& lhs, const Value& rhs)
+  {
+    Value val = lhs;
+    int tmask = do_tmask_of(lhs) | do_tmask_of(rhs);
+    Compare cmp;
 
-        do_rebind_nodes(dirty, bound.code_try, ctx_body);
-        do_rebind_nodes(dirty, bound.code_catch, ctx_body);
+    switch(weaken_enum(xop)) {
+      case xop_cmp_eq:
+        return Value(lhs.compare(rhs) == compare_equal);
 
-        return do_rebind_return_opt(dirty, ::std::move(bound));
-      }
+      case xop_cmp_ne:
+        return Value(lhs.compare(rhs) != compare_equal);
 
-      case index_throw_statement:
-      case index_assert_statement:
-      case index_return_statement:
-      case index_glvalue_to_prvalue:
-      case index_push_immediate:
-      case index_push_global_reference:
-        // There is nothing to rebind.
-        return nullopt;
+      case xop_cmp_lt:
+        cmp = lhs.compare(rhs);
+        if(cmp == compare_unordered)
+          return nullopt;
+        return Value(cmp == compare_less);
 
-      case index_push_local_reference: {
-        const auto& altr = this->m_stor.as<index_push_local_reference>();
+      case xop_cmp_gt:
+        cmp = lhs.compare(rhs);
+        if(cmp == compare_unordered)
+          return nullopt;
+        return Value(cmp == compare_greater);
 
-        // Get the context.
-        // Don't bind references in analytic contexts.
-        Abstract_Context* qctx = &ctx;
-        ::rocket::ranged_for(UINT32_C(0), altr.depth,
-                             [&](uint32_t) { qctx = qctx->get_parent_opt();  });
-        ROCKET_ASSERT(qctx);
-        if(qctx->is_analytic())
+      case xop_cmp_lte:
+        cmp = lhs.compare(rhs);
+        if(cmp == compare_unordered)
           return nullopt;
+        return Value(cmp != compare_greater);
 
-        // Look for the name in the context.
-        auto qref = qctx->get_named_reference_opt(altr.name);
-        if(!qref)
+      case xop_cmp_gte:
+        cmp = lhs.compare(rhs);
+        if(cmp == compare_unordered)
           return nullopt;
+        return Value(cmp != compare_less);
+
+      case xop_add:
+        if(tmask == tmask_boolean)
+          return Value(lhs.as_boolean() || rhs.as_boolean());
+        if(tmask == tmask_integer)
+          return Fast_add::apply(val, rhs.as_integer()) ? opt<Value>(val) : nullopt;
+        if((tmask == tmask_real) || (tmask == (tmask_real | tmask_integer)))
+          return Value(lhs.convert_to_real() + rhs.convert_to_real());
+        if(tmask == tmask_string)
+          return val.open_string().append(rhs.as_string()), val;
+        return nullopt;
 
-        // Bind it now.
-        S_push_bound_reference xnode = { *qref };
-        return ::std::move(xnode);
-      }
+      case xop_sub:
+        if(tmask == tmask_boolean)
+          return Value(lhs.as_boolean() != rhs.as_boolean());
+        if(tmask == tmask_integer)
+          return Fast_sub::apply(val, rhs.as_integer()) ? opt<Value>(val) : nullopt;
+        if((tmask == tmask_real) || (tmask == (tmask_real | tmask_integer)))
+          return Value(lhs.convert_to_real() - rhs.convert_to_real());
+        return nullopt;
 
-      case index_push_bound_reference:
-        // There is nothing to rebind.
+      case xop_mul:
+        if(tmask == tmask_boolean)
+          return Value(lhs.as_boolean() && rhs.as_boolean());
+        if(tmask == tmask_integer)
+          return Quick_mul_integer::apply(val, rhs) ? opt<Value>(val) : nullopt;
+        if((tmask == tmask_real) || (tmask == (tmask_real | tmask_integer)))
+          return Value(lhs.convert_to_real() * rhs.convert_to_real());
         return nullopt;
 
-      case index_define_function: {
-        const auto& altr = this->m_stor.as<index_define_function>();
+      case xop_div:
+        if(tmask == tmask_integer) {
+          int64_t x = lhs.as_integer();
+          int64_t y = rhs.as_integer();
+          if((y == 0) || ((x == INT64_MIN) && (y == -1)))
+            return nullopt;
+          return Value(x / y);
+        }
+        if((tmask == tmask_real) || (tmask == (tmask_real | tmask_integer)))
+          return Value(lhs.convert_to_real() / rhs.convert_to_real());
+        return nullopt;
 
-        // Rebind the function body.
-        Analytic_Context ctx_func(Analytic_Context::M_function(),
-                                  &ctx, altr.params);
-        bool dirty = false;
-        auto bound = altr;
+      case xop_mod:
+        if(tmask == tmask_integer) {
+          int64_t x = lhs.as_integer();
+          int64_t y = rhs.as_integer();
+          if((y == 0) || ((x == INT64_MIN) && (y == -1)))
+            return nullopt;
+          return Value(x % y);
+        }
+        if((tmask == tmask_real) || (tmask == (tmask_real | tmask_integer)))
+          return Value(::std::fmod(lhs.convert_to_real(), rhs.convert_to_real()));
+        return nullopt;
 
-        do_rebind_nodes(dirty, bound.code_body, ctx_func);
+      case xop_andb:
+        if(tmask == tmask_boolean)
+          return Value(lhs.as_boolean() && rhs.as_boolean());
+        if(tmask == tmask_integer)
+          return Value(lhs.as_integer() & rhs.as_integer());
+        return nullopt;
 
-        return do_rebind_return_opt(dirty, ::std::move(bound));
-      }
+      case xop_orb:
+        if(tmask == tmask_boolean)
+          return Value(lhs.as_boolean() || rhs.as_boolean());
+        if(tmask == tmask_integer)
+          return Value(lhs.as_integer() | rhs.as_integer());
+        return nullopt;
 
-      case index_branch_expression: {
-        const auto& altr = this->m_stor.as<index_branch_expression>();
+      case xop_xorb:
+        if(tmask == tmask_boolean)
+          return Value(lhs.as_boolean() != rhs.as_boolean());
+        if(tmask == tmask_integer)
+          return Value(lhs.as_integer() ^ rhs.as_integer());
+        return nullopt;
 
-        // Rebind the expression.
+      default:
+        return nullopt;
+    }
+  }
+
+// These are helper type traits.
+// Depending on the existence of Uparam, Sparam and Symbols, the code will look very
+// different.
+
+// check for `make_uparam`
+template<typename TraitsT, typename XNodeT, typename = void>
+struct Uparam_of
+  : ::rocket::identity<void>
+  { };
+
+template<typename TraitsT, typename XNodeT>
+struct Uparam_of<TraitsT, XNodeT, ROCKET_VOID_T(decltype(&TraitsT::make_uparam))>
+  : ::std::decay<decltype(TraitsT::make_uparam(::std::declval<bool&>(),
+                                               ::std::declval<const XNodeT&>()))>
+  { };
+
+// check for `make_sparam`
+template<typename TraitsT, typename XNodeT, typename = void>
+struct Sparam_of
+  : ::rocket::identity<void>
+  { };
+
+template<typename TraitsT, typename XNodeT>
+struct Sparam_of<TraitsT, XNodeT, ROCKET_VOID_T(decltype(&TraitsT::make_sparam))>
+  : ::std::decay<decltype(TraitsT::make_sparam(::std::declval<bool&>(),
+                                               ::std::declval<const XNodeT&>()))>
+  { };
+
+// check for `make_symbols`
+template<typename TraitsT, typename XNodeT, typename = void>
+struct Symbols_of
+  : ::rocket::identity<void>
+  { };
+
+template<typename TraitsT, typename XNodeT>
+struct Symbols_of<TraitsT, XNodeT, ROCKET_VOID_T(decltype(&TraitsT::make_symbols))>
+  : ::std::decay<decltype(TraitsT::make_symbols(::std::declval<const XNodeT&>()))>
+  { };
+
+// executor thunk
+template<typename TraitsT, typename UparamT, typename SparamT>
+struct Executor_of
+  {
+    static
+    AIR_Status
+    thunk(Executive_Context& ctx, AVMC_Queue::Uparam up, const void* sp)
+      { return TraitsT::execute(ctx, UparamT(up), *(const SparamT*)sp);  }
+  };
+
+template<typename TraitsT, typename UparamT>
+struct Executor_of<TraitsT, UparamT, void>
+  {
+    static
+    AIR_Status
+    thunk(Executive_Context& ctx, AVMC_Queue::Uparam up, const void* /*sp*/)
+      { return TraitsT::execute(ctx, UparamT(up));  }
+  };
+
+template<typename TraitsT, typename SparamT>
+struct Executor_of<TraitsT, void, SparamT>
+  {
+    static
+    AIR_Status
+    thunk(Executive_Context& ctx, AVMC_Queue::Uparam /*up*/, const void* sp)
+      { return TraitsT::execute(ctx, *(const SparamT*)sp);  }
+  };
+
+template<typename TraitsT>
+struct Executor_of<TraitsT, void, void>
+  {
+    static
+    AIR_Status
+    thunk(Executive_Context& ctx, AVMC_Queue::Uparam /*up*/, const void* /*sp*/)
+      { return TraitsT::execute(ctx);  }
+  };
+
+// enumerator thunk
+template<typename SparamT, typename = void>
+struct Enumerator_of
+  {
+    static constexpr AVMC_Queue::Enumerator* thunk = nullptr;
+  };
+
+template<typename SparamT>
+struct Enumerator_of<SparamT, ROCKET_VOID_T(decltype(&SparamT::enumerate_variables))>
+  {
+    static
+    Variable_Callback&
+    thunk(Variable_Callback& callback, AVMC_Queue::Uparam /*up*/, const void* sp)
+      { return static_cast<const SparamT*>(sp)->enumerate_variables(callback);  }
+  };
+
+// Finally...
+template<typename TraitsT, typename XNodeT, typename UparamT, typename SparamT,
+         typename SymbolT>
+struct AVMC_Appender
+  {
+    static
+    bool
+    do_append(AVMC_Queue& queue, const XNodeT& altr)
+      {
+        bool reachable = true;
+        queue.template append<Executor_of<TraitsT, UparamT, SparamT>::thunk,
+                              Enumerator_of<SparamT>::thunk>(
+                              TraitsT::make_symbols(altr),
+                              TraitsT::make_uparam(reachable, altr),
+                              TraitsT::make_sparam(reachable, altr));
+        return reachable;
+      }
+  };
+
+template<typename TraitsT, typename XNodeT, typename UparamT, typename SparamT>
+struct AVMC_Appender<TraitsT, XNodeT, UparamT, SparamT, void>
+  {
+    static
+    bool
+    do_append(AVMC_Queue& queue, const XNodeT& altr)
+      {
+        bool reachable = true;
+        queue.template append<Executor_of<TraitsT, UparamT, SparamT>::thunk,
+                              Enumerator_of<SparamT>::thunk>(
+                              TraitsT::make_uparam(reachable, altr),
+                              TraitsT::make_sparam(reachable, altr));
+        return reachable;
+      }
+  };
+
+template<typename TraitsT, typename XNodeT, typename UparamT, typename SymbolT>
+struct AVMC_Appender<TraitsT, XNodeT, UparamT, void, SymbolT>
+  {
+    static
+    bool
+    do_append(AVMC_Queue& queue, const XNodeT& altr)
+      {
+        bool reachable = true;
+        queue.template append<Executor_of<TraitsT, UparamT, void>::thunk,
+                              nullptr>(
+                              TraitsT::make_symbols(altr),
+                              TraitsT::make_uparam(reachable, altr));
+        return reachable;
+      }
+  };
+
+template<typename TraitsT, typename XNodeT, typename UparamT>
+struct AVMC_Appender<TraitsT, XNodeT, UparamT, void, void>
+  {
+    static
+    bool
+    do_append(AVMC_Queue& queue, const XNodeT& altr)
+      {
+        bool reachable = true;
+        queue.template append<Executor_of<TraitsT, UparamT, void>::thunk,
+                              nullptr>(
+                              TraitsT::make_uparam(reachable, altr));
+        return reachable;
+      }
+  };
+
+template<typename TraitsT, typename XNodeT, typename SparamT, typename SymbolT>
+struct AVMC_Appender<TraitsT, XNodeT, void, SparamT, SymbolT>
+  {
+    static
+    bool
+    do_append(AVMC_Queue& queue, const XNodeT& altr)
+      {
+        bool reachable = true;
+        queue.template append<Executor_of<TraitsT, void, SparamT>::thunk,
+                              Enumerator_of<SparamT>::thunk>(
+                              TraitsT::make_symbols(altr),
+                              AVMC_Queue::Uparam(),
+                              TraitsT::make_sparam(reachable, altr));
+        return reachable;
+      }
+  };
+
+template<typename TraitsT, typename XNodeT, typename SparamT>
+struct AVMC_Appender<TraitsT, XNodeT, void, SparamT, void>
+  {
+    static
+    bool
+    do_append(AVMC_Queue& queue, const XNodeT& altr)
+      {
+        bool reachable = true;
+        queue.template append<Executor_of<TraitsT, void, SparamT>::thunk,
+                              Enumerator_of<SparamT>::thunk>(
+                              AVMC_Queue::Uparam(),
+                              TraitsT::make_sparam(reachable, altr));
+        return reachable;
+      }
+  };
+
+template<typename TraitsT, typename XNodeT, typename SymbolT>
+struct AVMC_Appender<TraitsT, XNodeT, void, void, SymbolT>
+  {
+    static
+    bool
+    do_append(AVMC_Queue& queue, const XNodeT& altr)
+      {
+        bool reachable = true;
+        queue.template append<Executor_of<TraitsT, void, void>::thunk,
+                              nullptr>(
+                              TraitsT::make_symbols(altr),
+                              AVMC_Queue::Uparam());
+        return reachable;
+      }
+  };
+
+template<typename TraitsT, typename XNodeT>
+struct AVMC_Appender<TraitsT, XNodeT, void, void, void>
+  {
+    static
+    bool
+    do_append(AVMC_Queue& queue, const XNodeT& /*altr*/)
+      {
+        bool reachable = true;
+        queue.template append<Executor_of<TraitsT, void, void>::thunk,
+                              nullptr>(
+                              AVMC_Queue::Uparam());
+        return reachable;
+      }
+  };
+
+template<typename TraitsT, typename XNodeT>
+inline
+bool
+do_solidify(AVMC_Queue& queue, const XNodeT& altr)
+  {
+    using UparamT = typename Uparam_of<TraitsT, XNodeT>::type;
+    using SparamT = typename Sparam_of<TraitsT, XNodeT>::type;
+    using SymbolT = typename Symbols_of<TraitsT, XNodeT>::type;
+
+    do_name_executor<TraitsT, Executor_of<TraitsT, UparamT, SparamT>::thunk>();
+    return AVMC_Appender<TraitsT, XNodeT, UparamT, SparamT, SymbolT>::do_append(queue, altr);
+  }
+
+}  // namespace
+
+opt<AIR_Node>
+AIR_Node::
+rebind_opt(Abstract_Context& ctx)
+  const
+  {
+    switch(this->index()) {
+      case index_clear_stack:
+        // There is nothing to rebind.
+        return nullopt;
+
+      case index_execute_block: {
+        const auto& altr = this->m_stor.as<index_execute_block>();
+
+        // Rebind the body.
+        Analytic_Context ctx_body(Analytic_Context::M_plain(), ctx);
         bool dirty = false;
         auto bound = altr;
 
-        do_rebind_nodes(dirty, bound.code_true, ctx);
-        do_rebind_nodes(dirty, bound.code_false, ctx);
+        do_rebind_nodes(dirty, bound.code_body, ctx_body);
+
+        return do_rebind_return_opt(dirty, ::std::move(bound));
+      }
+
+      case index_declare_variable:
+      case index_initialize_variable:
+        // There is nothing to rebind.
+        return nullopt;
+
+      case index_if_statement: {
+        const auto& altr = this->m_stor.as<index_if_statement>();
+
+        // Rebind both branches.
+        Analytic_Context ctx_body(Analytic_Context::M_plain(), ctx);
+        bool dirty = false;
+        auto bound = altr;
+
+        do_rebind_nodes(dirty, bound.code_true, ctx_body);
+        do_rebind_nodes(dirty, bound.code_false, ctx_body);
+
+        return do_rebind_return_opt(dirty, ::std::move(bound));
+      }
+
+      case index_switch_statement: {
+        const auto& altr = this->m_stor.as<index_switch_statement>();
+
+        // Rebind all clauses.
+        Analytic_Context ctx_body(Analytic_Context::M_plain(), ctx);
+        bool dirty = false;
+        auto bound = altr;
+
+        do_rebind_nodes(dirty, bound.code_labels, ctx);  // this is not part of the body!
+        do_rebind_nodes(dirty, bound.code_bodies, ctx_body);
+
+        return do_rebind_return_opt(dirty, ::std::move(bound));
+      }
+
+      case index_do_while_statement: {
+        const auto& altr = this->m_stor.as<index_do_while_statement>();
+
+        // Rebind the body and the condition.
+        Analytic_Context ctx_body(Analytic_Context::M_plain(), ctx);
+        bool dirty = false;
+        auto bound = altr;
+
+        do_rebind_nodes(dirty, bound.code_body, ctx_body);
+        do_rebind_nodes(dirty, bound.code_cond, ctx);  // this is not part of the body!
+
+        return do_rebind_return_opt(dirty, ::std::move(bound));
+      }
+
+      case index_while_statement: {
+        const auto& altr = this->m_stor.as<index_while_statement>();
+
+        // Rebind the condition and the body.
+        Analytic_Context ctx_body(Analytic_Context::M_plain(), ctx);
+        bool dirty = false;
+        auto bound = altr;
+
+        do_rebind_nodes(dirty, bound.code_cond, ctx);  // this is not part of the body!
+        do_rebind_nodes(dirty, bound.code_body, ctx_body);
+
+        return do_rebind_return_opt(dirty, ::std::move(bound));
+      }
+
+      case index_for_each_statement: {
+        const auto& altr = this->m_stor.as<index_for_each_statement>();
+
+        // Rebind the range initializer and the body.
+        Analytic_Context ctx_for(Analytic_Context::M_plain(), ctx);
+        Analytic_Context ctx_body(Analytic_Context::M_plain(), ctx_for);
+        bool dirty = false;
+        auto bound = altr;
+
+        do_rebind_nodes(dirty, bound.code_init, ctx_for);
+        do_rebind_nodes(dirty, bound.code_body, ctx_body);
+
+        return do_rebind_return_opt(dirty, ::std::move(bound));
+      }
+
+      case index_for_statement: {
+        const auto& altr = this->m_stor.as<index_for_statement>();
+
+        // Rebind the initializer, the condition, the loop increment and the body.
+        Analytic_Context ctx_for(Analytic_Context::M_plain(), ctx);
+        Analytic_Context ctx_body(Analytic_Context::M_plain(), ctx_for);
+        bool dirty = false;
+        auto bound = altr;
+
+        do_rebind_nodes(dirty, bound.code_init, ctx_for);
+        do_rebind_nodes(dirty, bound.code_cond, ctx_for);
+        do_rebind_nodes(dirty, bound.code_step, ctx_for);
+        do_rebind_nodes(dirty, bound.code_body, ctx_body);
+
+        return do_rebind_return_opt(dirty, ::std::move(bound));
+      }
+
+      case index_try_statement: {
+        const auto& altr = this->m_stor.as<index_try_statement>();
+
+        // Rebind the `try` and `catch` clauses.
+        Analytic_Context ctx_body(Analytic_Context::M_plain(), ctx);
+        bool dirty = false;
+        auto bound = altr;
+
+        do_rebind_nodes(dirty, bound.code_try, ctx_body);
+        do_rebind_nodes(dirty, bound.code_catch, ctx_body);
+
+        return do_rebind_return_opt(dirty, ::std::move(bound));
+      }
+
+      case index_throw_statement:
+      case index_assert_statement:
+      case index_return_statement:
+      case index_glvalue_to_prvalue:
+      case index_push_immediate:
+      case index_push_global_reference:
+        // There is nothing to rebind.
+        return nullopt;
+
+      case index_push_local_reference: {
+        const auto& altr = this->m_stor.as<index_push_local_reference>();
+
+        // Get the context.
+        // Don't bind references in analytic contexts.
+        Abstract_Context* qctx = &ctx;
+        ::rocket::ranged_for(UINT32_C(0), altr.depth,
+                             [&](uint32_t) { qctx = qctx->get_parent_opt();  });
+        ROCKET_ASSERT(qctx);
+        if(qctx->is_analytic())
+          return nullopt;
+
+        // Look for the name in the context.
+        auto qref = qctx->get_named_reference_opt(altr.name, altr.slot);
+        if(!qref)
+          return nullopt;
+
+        // Bind it now.
+        S_push_bound_reference xnode = { *qref };
+        return ::std::move(xnode);
+      }
+
+      case index_push_bound_reference:
+        // There is nothing to rebind.
+        return nullopt;
+
+      case index_define_function: {
+        const auto& altr = this->m_stor.as<index_define_function>();
+
+        // Rebind the function body.
+        Analytic_Context ctx_func(Analytic_Context::M_function(),
+                                  &ctx, altr.params);
+        bool dirty = false;
+        auto bound = altr;
+
+        do_rebind_nodes(dirty, bound.code_body, ctx_func);
+
+        return do_rebind_return_opt(dirty, ::std::move(bound));
+      }
+
+      case index_branch_expression: {
+        const auto& altr = this->m_stor.as<index_branch_expression>();
+
+        // Rebind the expression.
+        bool dirty = false;
+        auto bound = altr;
+
+        do_rebind_nodes(dirty, bound.code_true, ctx);
+        do_rebind_nodes(dirty, bound.code_false, ctx);
+
+        return do_rebind_return_opt(dirty, ::std::move(bound));
+      }
+
+      case index_coalescence: {
+        const auto& altr = this->m_stor.as<index_coalescence>();
+
+        // Rebind the expression.
+        bool dirty = false;
+        auto bound = altr;
+
+        do_rebind_nodes(dirty, bound.code_null, ctx);
+
+        return do_rebind_return_opt(dirty, ::std::move(bound));
+      }
+
+      case index_function_call:
+      case index_member_access:
+      case index_push_unnamed_array:
+      case index_push_unnamed_object:
+      case index_apply_operator:
+      case index_unpack_struct_array:
+      case index_unpack_struct_object:
+      case index_define_null_variable:
+      case index_single_step_trap:
+      case index_variadic_call:
+        // There is nothing to rebind.
+        return nullopt;
+
+      case index_defer_expression: {
+        const auto& altr = this->m_stor.as<index_defer_expression>();
+
+        // Rebind the expression.
+        bool dirty = false;
+        auto bound = altr;
+
+        do_rebind_nodes(dirty, bound.code_body, ctx);
+
+        return do_rebind_return_opt(dirty, ::std::move(bound));
+      }
+
+      case index_import_call:
+      case index_break_or_continue:
+      case index_declare_reference:
+      case index_initialize_reference:
+        // There is nothing to rebind.
+        return nullopt;
+
+      case index_inline_call:
+        // Only functions that reference nothing outside are inlined, so there is
+        // nothing to rebind.
+        return nullopt;
+
+      default:
+        ASTERIA_TERMINATE("invalid AIR node type (index `$1`)", this->index());
+    }
+  }
+
+bool
+AIR_Node::
+solidify(AVMC_Queue& queue)
+  const
+  {
+    switch(this->index()) {
+      case index_clear_stack:
+        return do_solidify<AIR_Traits_clear_stack>(queue,
+                                     this->m_stor.as<index_clear_stack>());
+
+      case index_execute_block:
+        return do_solidify<AIR_Traits_execute_block>(queue,
+                                     this->m_stor.as<index_execute_block>());
+
+      case index_declare_variable:
+        return do_solidify<AIR_Traits_declare_variable>(queue,
+                                     this->m_stor.as<index_declare_variable>());
+
+      case index_initialize_variable:
+        return do_solidify<AIR_Traits_initialize_variable>(queue,
+                                     this->m_stor.as<index_initialize_variable>());
+
+      case index_if_statement:
+        return do_solidify<AIR_Traits_if_statement>(queue,
+                                     this->m_stor.as<index_if_statement>());
+
+      case index_switch_statement:
+        return do_solidify<AIR_Traits_switch_statement>(queue,
+                                     this->m_stor.as<index_switch_statement>());
+
+      case index_do_while_statement:
+        return do_solidify<AIR_Traits_do_while_statement>(queue,
+                                     this->m_stor.as<index_do_while_statement>());
+
+      case index_while_statement:
+        return do_solidify<AIR_Traits_while_statement>(queue,
+                                     this->m_stor.as<index_while_statement>());
+
+      case index_for_each_statement:
+        return do_solidify<AIR_Traits_for_each_statement>(queue,
+                                     this->m_stor.as<index_for_each_statement>());
+
+      case index_for_statement:
+        return do_solidify<AIR_Traits_for_statement>(queue,
+                                     this->m_stor.as<index_for_statement>());
+
+      case index_try_statement:
+        return do_solidify<AIR_Traits_try_statement>(queue,
+                                     this->m_stor.as<index_try_statement>());
+
+      case index_throw_statement:
+        return do_solidify<AIR_Traits_throw_statement>(queue,
+                                     this->m_stor.as<index_throw_statement>());
+
+      case index_assert_statement:
+        return do_solidify<AIR_Traits_assert_statement>(queue,
+                                     this->m_stor.as<index_assert_statement>());
+
+      case index_return_statement:
+        return do_solidify<AIR_Traits_return_statement>(queue,
+                                     this->m_stor.as<index_return_statement>());
+
+      case index_glvalue_to_prvalue:
+        return do_solidify<AIR_Traits_glvalue_to_prvalue>(queue,
+                                     this->m_stor.as<index_glvalue_to_prvalue>());
+
+      case index_push_immediate: {
+        const auto& altr = this->m_stor.as<index_push_immediate>();
+        switch(weaken_enum(altr.value.type())) {
+          case type_null:
+            return do_solidify<AIR_Traits_push_immediate_null>(queue, altr);
+
+          case type_boolean:
+            return do_solidify<AIR_Traits_push_immediate_boolean>(queue, altr);
+
+          case type_integer:
+            if(do_is_int48(altr.value.as_integer()))
+              return do_solidify<AIR_Traits_push_immediate_int48>(queue, altr);
+            else
+              // Fallthrough
+          default:
+              return do_solidify<AIR_Traits_push_immediate_generic>(queue, altr);
+        }
+      }
+
+      case index_push_global_reference:
+        return do_solidify<AIR_Traits_push_global_reference>(queue,
+                                     this->m_stor.as<index_push_global_reference>());
+
+      case index_push_local_reference:
+        return do_solidify<AIR_Traits_push_local_reference>(queue,
+                                     this->m_stor.as<index_push_local_reference>());
+
+      case index_push_bound_reference:
+        return do_solidify<AIR_Traits_push_bound_reference>(queue,
+                                     this->m_stor.as<index_push_bound_reference>());
+
+      case index_define_function:
+        return do_solidify<AIR_Traits_define_function>(queue,
+                                     this->m_stor.as<index_define_function>());
+
+      case index_branch_expression:
+        return do_solidify<AIR_Traits_branch_expression>(queue,
+                                     this->m_stor.as<index_branch_expression>());
+
+      case index_coalescence:
+        return do_solidify<AIR_Traits_coalescence>(queue,
+                                     this->m_stor.as<index_coalescence>());
+
+      case index_function_call:
+        return do_solidify<AIR_Traits_function_call>(queue,
+                                     this->m_stor.as<index_function_call>());
+
+      case index_member_access:
+        return do_solidify<AIR_Traits_member_access>(queue,
+                                     this->m_stor.as<index_member_access>());
+
+      case index_push_unnamed_array:
+        return do_solidify<AIR_Traits_push_unnamed_array>(queue,
+                                     this->m_stor.as<index_push_unnamed_array>());
+
+      case index_push_unnamed_object:
+        return do_solidify<AIR_Traits_push_unnamed_object>(queue,
+                                     this->m_stor.as<index_push_unnamed_object>());
+
+      case index_apply_operator: {
+        const auto& altr = this->m_stor.as<index_apply_operator>();
+        switch(altr.xop) {
+          case xop_inc_post:
+            return do_solidify<AIR_Traits_apply_operator_inc_post>(queue, altr);
+
+          case xop_dec_post:
+            return do_solidify<AIR_Traits_apply_operator_dec_post>(queue, altr);
+
+          case xop_subscr:
+            return do_solidify<AIR_Traits_apply_operator_subscr>(queue, altr);
+
+          case xop_pos:
+            return do_solidify<AIR_Traits_apply_operator_pos>(queue, altr);
+
+          case xop_neg:
+            return do_solidify<AIR_Traits_apply_operator_neg>(queue, altr);
+
+          case xop_notb:
+            return do_solidify<AIR_Traits_apply_operator_notb>(queue, altr);
+
+          case xop_notl:
+            return do_solidify<AIR_Traits_apply_operator_notl>(queue, altr);
+
+          case xop_inc_pre:
+            return do_solidify<AIR_Traits_apply_operator_inc_pre>(queue, altr);
+
+          case xop_dec_pre:
+            return do_solidify<AIR_Traits_apply_operator_dec_pre>(queue, altr);
+
+          case xop_unset:
+            return do_solidify<AIR_Traits_apply_operator_unset>(queue, altr);
+
+          case xop_countof:
+            return do_solidify<AIR_Traits_apply_operator_countof>(queue, altr);
+
+          case xop_typeof:
+            return do_solidify<AIR_Traits_apply_operator_typeof>(queue, altr);
+
+          case xop_sqrt:
+            return do_solidify<AIR_Traits_apply_operator_sqrt>(queue, altr);
+
+          case xop_isnan:
+            return do_solidify<AIR_Traits_apply_operator_isnan>(queue, altr);
+
+          case xop_isinf:
+            return do_solidify<AIR_Traits_apply_operator_isinf>(queue, altr);
+
+          case xop_abs:
+            return do_solidify<AIR_Traits_apply_operator_abs>(queue, altr);
+
+          case xop_sign:
+            return do_solidify<AIR_Traits_apply_operator_sign>(queue, altr);
+
+          case xop_round:
+            return do_solidify<AIR_Traits_apply_operator_round>(queue, altr);
+
+          case xop_floor:
+            return do_solidify<AIR_Traits_apply_operator_floor>(queue, altr);
+
+          case xop_ceil:
+            return do_solidify<AIR_Traits_apply_operator_ceil>(queue, altr);
+
+          case xop_trunc:
+            return do_solidify<AIR_Traits_apply_operator_trunc>(queue, altr);
+
+          case xop_iround:
+            return do_solidify<AIR_Traits_apply_operator_iround>(queue, altr);
+
+          case xop_ifloor:
+            return do_solidify<AIR_Traits_apply_operator_ifloor>(queue, altr);
+
+          case xop_iceil:
+            return do_solidify<AIR_Traits_apply_operator_iceil>(queue, altr);
+
+          case xop_itrunc:
+            return do_solidify<AIR_Traits_apply_operator_itrunc>(queue, altr);
+
+          case xop_cmp_eq:
+            return AIR_Traits_quick_compare<AIR_Traits_apply_operator_cmp_eq,
+                                     ::std::equal_to>::do_append(queue, altr);
+
+          case xop_cmp_ne:
+            return AIR_Traits_quick_compare<AIR_Traits_apply_operator_cmp_ne,
+                                     ::std::not_equal_to>::do_append(queue, altr);
+
+          case xop_cmp_lt:
+            return AIR_Traits_quick_compare<AIR_Traits_apply_operator_cmp_lt,
+                                     ::std::less>::do_append(queue, altr);
+
+          case xop_cmp_gt:
+            return AIR_Traits_quick_compare<AIR_Traits_apply_operator_cmp_gt,
+                                     ::std::greater>::do_append(queue, altr);
+
+          case xop_cmp_lte:
+            return AIR_Traits_quick_compare<AIR_Traits_apply_operator_cmp_lte,
+                                     ::std::less_equal>::do_append(queue, altr);
+
+          case xop_cmp_gte:
+            return AIR_Traits_quick_compare<AIR_Traits_apply_operator_cmp_gte,
+                                     ::std::greater_equal>::do_append(queue, altr);
+
+          case xop_cmp_3way:
+            return do_solidify<AIR_Traits_apply_operator_cmp_3way>(queue, altr);
+
+          case xop_add:
+            return AIR_Traits_quick_binary<AIR_Traits_apply_operator_add,
+                                     Quick_add_integer, Quick_add_real>::do_append(queue, altr);
+
+          case xop_sub:
+            return AIR_Traits_quick_binary<AIR_Traits_apply_operator_sub,
+                                     Quick_sub_integer, Quick_sub_real>::do_append(queue, altr);
+
+          case xop_mul:
+            return AIR_Traits_quick_binary<AIR_Traits_apply_operator_mul,
+                                     Quick_mul_integer, Quick_mul_real>::do_append(queue, altr);
+
+          case xop_div:
+            return do_solidify<AIR_Traits_apply_operator_div>(queue, altr);
+
+          case xop_mod:
+            return do_solidify<AIR_Traits_apply_operator_mod>(queue, altr);
+
+          case xop_sll:
+            return do_solidify<AIR_Traits_apply_operator_sll>(queue, altr);
+
+          case xop_srl:
+            return do_solidify<AIR_Traits_apply_operator_srl>(queue, altr);
+
+          case xop_sla:
+            return do_solidify<AIR_Traits_apply_operator_sla>(queue, altr);
+
+          case xop_sra:
+            return do_solidify<AIR_Traits_apply_operator_sra>(queue, altr);
+
+          case xop_andb:
+            return do_solidify<AIR_Traits_apply_operator_andb>(queue, altr);
+
+          case xop_orb:
+            return do_solidify<AIR_Traits_apply_operator_orb>(queue, altr);
+
+          case xop_xorb:
+            return do_solidify<AIR_Traits_apply_operator_xorb>(queue, altr);
+
+          case xop_assign:
+            return do_solidify<AIR_Traits_apply_operator_assign>(queue, altr);
+
+          case xop_fma:
+            return do_solidify<AIR_Traits_apply_operator_fma>(queue, altr);
+
+          case xop_head:
+            return do_solidify<AIR_Traits_apply_operator_head>(queue, altr);
+
+          case xop_tail:
+            return do_solidify<AIR_Traits_apply_operator_tail>(queue, altr);
+
+          default:
+            ASTERIA_TERMINATE("invalid operator type (xop `$1`)", altr.xop);
+        }
+      }
+
+      case index_unpack_struct_array:
+        return do_solidify<AIR_Traits_unpack_struct_array>(queue,
+                                     this->m_stor.as<index_unpack_struct_array>());
+
+      case index_unpack_struct_object:
+        return do_solidify<AIR_Traits_unpack_struct_object>(queue,
+                                     this->m_stor.as<index_unpack_struct_object>());
+
+      case index_define_null_variable:
+        return do_solidify<AIR_Traits_define_null_variable>(queue,
+                                     this->m_stor.as<index_define_null_variable>());
+
+      case index_single_step_trap:
+        return do_solidify<AIR_Traits_single_step_trap>(queue,
+                                     this->m_stor.as<index_single_step_trap>());
+
+      case index_variadic_call:
+        return do_solidify<AIR_Traits_variadic_call>(queue,
+                                     this->m_stor.as<index_variadic_call>());
+
+      case index_defer_expression:
+        return do_solidify<AIR_Traits_defer_expression>(queue,
+                                     this->m_stor.as<index_defer_expression>());
+
+      case index_import_call:
+        return do_solidify<AIR_Traits_import_call>(queue,
+                                     this->m_stor.as<index_import_call>());
+
+      case index_break_or_continue:
+        return do_solidify<AIR_Traits_break_or_continue>(queue,
+                                     this->m_stor.as<index_break_or_continue>());
+
+      case index_declare_reference:
+        return do_solidify<AIR_Traits_declare_reference>(queue,
+                                     this->m_stor.as<index_declare_reference>());
+
+      case index_initialize_reference:
+        return do_solidify<AIR_Traits_initialize_reference>(queue,
+                                     this->m_stor.as<index_initialize_reference>());
+
+      case index_inline_call:
+        return do_solidify<AIR_Traits_inline_call>(queue,
+                                     this->m_stor.as<index_inline_call>());
+
+      default:
+        ASTERIA_TERMINATE("invalid AIR node type (index `$1`)", this->index());
+    }
+  }
+
+opt<bool>
+AIR_Node::
+solidify_fused_opt(AVMC_Queue& queue, const AIR_Node& next)
+  const
+  {
+    switch(weaken_enum(this->index())) {
+      case index_push_local_reference: {
+        const auto& altr = this->m_stor.as<index_push_local_reference>();
+        if(next.index() != index_glvalue_to_prvalue)
+          return nullopt;
+
+        // `x` as an argument by value
+        S_fused_local_to_prvalue xfused = { altr, next.m_stor.as<index_glvalue_to_prvalue>() };
+        return do_solidify<AIR_Traits_fused_local_to_prvalue>(queue, xfused);
+      }
+
+      case index_push_immediate: {
+        const auto& altr = this->m_stor.as<index_push_immediate>();
+        if((next.index() != index_apply_operator) || !do_is_fusible_immediate(altr.value))
+          return nullopt;
+
+        // `x + 1`, `x < 10`, etc.
+        const auto& xnext = next.m_stor.as<index_apply_operator>();
+        S_fused_immediate_operator xfused = { altr, xnext };
+        switch(weaken_enum(xnext.xop)) {
+          case xop_add:
+            return do_solidify<AIR_Traits_fused_immediate_operator<
+                          AIR_Traits_apply_operator_add, Fast_add>>(queue, xfused);
+
+          case xop_sub:
+            return do_solidify<AIR_Traits_fused_immediate_operator<
+                          AIR_Traits_apply_operator_sub, Fast_sub>>(queue, xfused);
+
+          case xop_cmp_eq:
+            return do_solidify<AIR_Traits_fused_immediate_operator<
+                          AIR_Traits_apply_operator_cmp_eq,
+                          Fast_compare<::std::equal_to<int64_t>>>>(queue, xfused);
+
+          case xop_cmp_ne:
+            return do_solidify<AIR_Traits_fused_immediate_operator<
+                          AIR_Traits_apply_operator_cmp_ne,
+                          Fast_compare<::std::not_equal_to<int64_t>>>>(queue, xfused);
+
+          case xop_cmp_lt:
+            return do_solidify<AIR_Traits_fused_immediate_operator<
+                          AIR_Traits_apply_operator_cmp_lt,
+                          Fast_compare<::std::less<int64_t>>>>(queue, xfused);
+
+          case xop_cmp_gt:
+            return do_solidify<AIR_Traits_fused_immediate_operator<
+                          AIR_Traits_apply_operator_cmp_gt,
+                          Fast_compare<::std::greater<int64_t>>>>(queue, xfused);
+
+          case xop_cmp_lte:
+            return do_solidify<AIR_Traits_fused_immediate_operator<
+                          AIR_Traits_apply_operator_cmp_lte,
+                          Fast_compare<::std::less_equal<int64_t>>>>(queue, xfused);
+
+          case xop_cmp_gte:
+            return do_solidify<AIR_Traits_fused_immediate_operator<
+                          AIR_Traits_apply_operator_cmp_gte,
+                          Fast_compare<::std::greater_equal<int64_t>>>>(queue, xfused);
+
+          default:
+            return nullopt;
+        }
+      }
+
+      default:
+        return nullopt;
+    }
+  }
+
+bool
+AIR_Node::
+solidify_all(AVMC_Queue& queue, const cow_vector<AIR_Node>& code)
+  {
+    size_t k = 0;
+    while(k != code.size()) {
+      // Try fusing this node with the next one.
+      opt<bool> reachable;
+      if(k + 1 != code.size())
+        reachable = code[k].solidify_fused_opt(queue, code[k+1]);
+
+      if(reachable)
+        k += 2;
+      else
+        reachable = code[k++].solidify(queue);
+
+      // Stop if all subsequent nodes are unreachable.
+      if(!*reachable)
+        return false;
+    }
+    return true;
+  }
+
+struct AIR_Node::Fold_Context
+  {
+    // Each element contains immutable variables of a context, with the current
+    // context at the end. Nested blocks are folded in new frames, so a local
+    // reference `depth` levels up can be found in `frames` directly.
+    // A variable maps to an `S_push_immediate` node for its value, or an
+    // `S_define_function` node if it is a function that can be inlined.
+    cow_vector<cow_dictionary<AIR_Node>> frames;
+
+    // These are string constants that have been seen so far.
+    cow_dictionary<Value> strings;
+
+    // These are used for inlining.
+    bool inline_calls;
+    size_t min_frame;  // the outermost frame that has been referenced
+    size_t nnodes;  // the number of nodes that have been folded
+    bool inlinable;  // whether the last function can be inlined
+  };
+
+namespace {
+
+// Functions whose bodies have more nodes than this are not inlined.
+constexpr size_t inline_max_nodes = 32;
+
+}  // namespace
+
+bool
+AIR_Node::
+do_fold_constants(cow_vector<AIR_Node>& code, Fold_Context& fctx)
+  {
+    auto& frames = fctx.frames;
+
+    auto fold_scope = [&](cow_vector<AIR_Node>& body)
+      {
+        frames.emplace_back();
+        bool r = do_fold_constants(body, fctx);
+        frames.pop_back();
+        return r;
+      };
+
+    auto is_immediate = [&](const cow_vector<AIR_Node>& out, size_t k)
+      { return (out.size() >= k) && (out[out.size() - k].index() == index_push_immediate);  };
+
+    auto get_immediate = [&](const cow_vector<AIR_Node>& out, size_t k) -> const Value&
+      { return out[out.size() - k].m_stor.as<index_push_immediate>().value;  };
+
+    // If `xnode` pushes exactly one value onto the stack, get the number of values
+    // that it pops. Otherwise, a null value is returned.
+    auto get_noperands_opt = [&](const AIR_Node& xnode) -> opt<size_t>
+      {
+        switch(weaken_enum(xnode.index())) {
+          case index_push_immediate:
+          case index_push_global_reference:
+          case index_push_local_reference:
+          case index_push_bound_reference:
+          case index_define_function:
+            return 0;
+
+          case index_glvalue_to_prvalue:
+          case index_branch_expression:
+          case index_coalescence:
+          case index_member_access:
+            return 1;
+
+          case index_function_call:
+            return xnode.m_stor.as<index_function_call>().nargs + size_t(1);
+
+          case index_inline_call:
+            return xnode.m_stor.as<index_inline_call>().nargs;
+
+          case index_push_unnamed_array:
+            return xnode.m_stor.as<index_push_unnamed_array>().nelems;
+
+          case index_push_unnamed_object:
+            return xnode.m_stor.as<index_push_unnamed_object>().keys.size();
+
+          case index_apply_operator:
+            switch(weaken_enum(xnode.m_stor.as<index_apply_operator>().xop)) {
+              case xop_subscr:
+              case xop_cmp_eq:
+              case xop_cmp_ne:
+              case xop_cmp_lt:
+              case xop_cmp_gt:
+              case xop_cmp_lte:
+              case xop_cmp_gte:
+              case xop_cmp_3way:
+              case xop_add:
+              case xop_sub:
+              case xop_mul:
+              case xop_div:
+              case xop_mod:
+              case xop_sll:
+              case xop_srl:
+              case xop_sla:
+              case xop_sra:
+              case xop_andb:
+              case xop_orb:
+              case xop_xorb:
+              case xop_assign:
+                return 2;
+
+              case xop_fma:
+                return 3;
+
+              default:
+                return 1;
+            }
+
+          default:
+            return nullopt;
+        }
+      };
+
+    bool dirty = false;
+    cow_vector<AIR_Node> out;
+    out.reserve(code.size());
+
+    // If `xnode` references an immutable variable with a constant value, get the
+    // node that pushes its value. Otherwise, a null pointer is returned.
+    auto get_constant_opt = [&](const AIR_Node& xnode) -> const AIR_Node*
+      {
+        if(xnode.index() != index_push_local_reference)
+          return nullptr;
+
+        const auto& xref = xnode.m_stor.as<index_push_local_reference>();
+        if(xref.depth >= frames.size())
+          return nullptr;
+
+        auto qinit = frames[frames.size() - 1 - xref.depth].ptr(xref.name);
+        if(!qinit || (qinit->index() != index_push_immediate))
+          return nullptr;
+        return qinit;
+      };
+
+    // Conditions are only tested, so conversions of constants are no-ops and can
+    // be removed.
+    auto strip_condition = [&]
+      {
+        if(!is_immediate(out, 2) || (out.back().index() != index_glvalue_to_prvalue))
+          return;
+
+        dirty = true;
+        out.pop_back();
+      };
+
+    // Replace references to immutable variables with their values, where the top
+    // `nops` operands are read by value. References that are bound or modified
+    // are left alone, so errors are reported as if nothing had been propagated.
+    auto propagate_operands = [&](size_t nops)
+      {
+        size_t pos = out.size();
+        for(size_t k = 0;  k != nops;  ++k) {
+          if(pos == 0)
+            return;
+
+          // The last node of an operand pushes its value.
+          size_t root = pos - 1;
+          if(auto qinit = get_constant_opt(out[root])) {
+            dirty = true;
+            out.mut(root) = *qinit;
+          }
+
+          // Skip the other nodes of this operand.
+          size_t nvals = 1;
+          while(nvals && pos) {
+            auto qnops = get_noperands_opt(out[--pos]);
+            if(!qnops)
+              return;
+            nvals = nvals - 1 + *qnops;
+          }
+          if(nvals)
+            return;
+        }
+      };
+
+    for(size_t i = 0;  i < code.size();  ++i) {
+      AIR_Node node = code[i];
+      fctx.nnodes++;
+
+      switch(weaken_enum(node.index())) {
+        case index_execute_block: {
+          auto& altr = node.m_stor.as<index_execute_block>();
+          dirty |= fold_scope(altr.code_body);
+          break;
+        }
+
+        case index_declare_variable: {
+          const auto& altr = node.m_stor.as<index_declare_variable>();
+          frames.mut_back().erase(altr.name);
+          break;
+        }
+
+        case index_initialize_variable: {
+          const auto& altr = node.m_stor.as<index_initialize_variable>();
+          propagate_operands(1);
+          if(!altr.immutable || (out.size() < 2))
+            break;
+
+          const auto& decl = out[out.size() - 2];
+          if(decl.index() != index_declare_variable)
+            break;
+
+          const auto& name = decl.m_stor.as<index_declare_variable>().name;
+          const auto& init = out.back();
+          if(init.index() == index_push_immediate)
+            // `const x = 42;`
+            frames.mut_back().insert_or_assign(name, init);
+          else if((init.index() == index_define_function) && fctx.inlinable)
+            // `func f(x) { ... }`
+            frames.mut_back().insert_or_assign(name, init);
+          break;
+        }
+
+        case index_if_statement: {
+          auto& altr = node.m_stor.as<index_if_statement>();
+          propagate_operands(1);
+          strip_condition();
+          dirty |= fold_scope(altr.code_true);
+          dirty |= fold_scope(altr.code_false);
+          if(!is_immediate(out, 1))
+            break;
+
+          // Select a branch according to the condition, which is left on the stack.
+          dirty = true;
+          bool cond = get_immediate(out, 1).test() != altr.negative;
+          auto& code_taken = cond ? altr.code_true : altr.code_false;
+          if(code_taken.empty())
+            continue;
+
+          S_execute_block xnode = { ::std::move(code_taken) };
+          node = ::std::move(xnode);
+          break;
+        }
+
+        case index_switch_statement: {
+          auto& altr = node.m_stor.as<index_switch_statement>();
+
+          // Labels are evaluated in the current context. All clauses share a
+          // context, but a clause may bypass declarations in previous ones, so
+          // each of them is folded in a separated frame.
+          for(size_t k = 0;  k < altr.code_labels.size();  ++k)
+            if(do_fold_constants(altr.code_labels.mut(k), fctx))
+              dirty = true;
+
+          for(size_t k = 0;  k < altr.code_bodies.size();  ++k)
+            if(fold_scope(altr.code_bodies.mut(k)))
+              dirty = true;
+          break;
+        }
+
+        case index_do_while_statement: {
+          auto& altr = node.m_stor.as<index_do_while_statement>();
+          dirty |= fold_scope(altr.code_body);
+          dirty |= do_fold_constants(altr.code_cond, fctx);
+          break;
+        }
+
+        case index_while_statement: {
+          auto& altr = node.m_stor.as<index_while_statement>();
+          dirty |= do_fold_constants(altr.code_cond, fctx);
+          dirty |= fold_scope(altr.code_body);
+          break;
+        }
+
+        case index_for_each_statement: {
+          auto& altr = node.m_stor.as<index_for_each_statement>();
+          frames.emplace_back();
+          dirty |= do_fold_constants(altr.code_init, fctx);
+          dirty |= fold_scope(altr.code_body);
+          frames.pop_back();
+          break;
+        }
+
+        case index_for_statement: {
+          auto& altr = node.m_stor.as<index_for_statement>();
+          frames.emplace_back();
+          dirty |= do_fold_constants(altr.code_init, fctx);
+          dirty |= do_fold_constants(altr.code_cond, fctx);
+          dirty |= do_fold_constants(altr.code_step, fctx);
+          dirty |= fold_scope(altr.code_body);
+          frames.pop_back();
+          break;
+        }
+
+        case index_try_statement: {
+          auto& altr = node.m_stor.as<index_try_statement>();
+          dirty |= fold_scope(altr.code_try);
+          dirty |= fold_scope(altr.code_catch);
+          break;
+        }
+
+        case index_push_immediate: {
+          auto& altr = node.m_stor.as<index_push_immediate>();
+          if(!altr.value.is_string())
+            break;
+
+          // Share storage of equal strings.
+          const auto& str = altr.value.as_string();
+          auto qstr = fctx.strings.ptr(phsh_string(str));
+          if(!qstr) {
+            fctx.strings.try_emplace(phsh_string(str), altr.value);
+            break;
+          }
+          if(qstr->as_string().data() == str.data())
+            break;
+
+          dirty = true;
+          altr.value = *qstr;
+          break;
+        }
+
+        case index_push_local_reference: {
+          const auto& altr = node.m_stor.as<index_push_local_reference>();
+          if(altr.depth >= frames.size()) {
+            // This references something outside the outermost function.
+            fctx.min_frame = 0;
+            break;
+          }
+
+          // A reference to an immutable variable is replaced with its value by the
+          // node that reads it, if any. If it's not replaced, the frame is marked
+          // after all nodes have been folded.
+          if(get_constant_opt(node))
+            break;
+
+          size_t index = frames.size() - 1 - altr.depth;
+          fctx.min_frame = ::rocket::min(fctx.min_frame, index);
+          break;
+        }
+
+        case index_glvalue_to_prvalue:
+        case index_assert_statement:
+        case index_throw_statement:
+          propagate_operands(1);
+          break;
+
+        case index_push_unnamed_array:
+          propagate_operands(node.m_stor.as<index_push_unnamed_array>().nelems);
+          break;
+
+        case index_push_unnamed_object:
+          propagate_operands(node.m_stor.as<index_push_unnamed_object>().keys.size());
+          break;
+
+        case index_define_function: {
+          auto& altr = node.m_stor.as<index_define_function>();
+
+          // Fold the body in a new frame. A function can be inlined if it is small,
+          // and references nothing outside its own frame, which also rules out
+          // recursion.
+          size_t min_frame = ::std::exchange(fctx.min_frame, SIZE_MAX);
+          size_t nnodes = fctx.nnodes;
+          dirty |= fold_scope(altr.code_body);
+
+          fctx.inlinable = fctx.inline_calls &&
+                           (fctx.min_frame >= frames.size()) &&
+                           (fctx.nnodes - nnodes <= inline_max_nodes) &&
+                           (altr.params.empty() || (altr.params.back() != "..."));
+          fctx.min_frame = ::rocket::min(fctx.min_frame, min_frame);
+          break;
+        }
+
+        case index_branch_expression: {
+          auto& altr = node.m_stor.as<index_branch_expression>();
+          dirty |= do_fold_constants(altr.code_true, fctx);
+          dirty |= do_fold_constants(altr.code_false, fctx);
+
+          // If a branch is empty, the condition may be the result, which is not
+          // read by value.
+          if(!altr.assign && !altr.code_true.empty() && !altr.code_false.empty()) {
+            propagate_operands(1);
+            strip_condition();
+          }
+          if(altr.assign || !is_immediate(out, 1))
+            break;
+
+          // If the branch taken is empty, the condition is the result. Otherwise,
+          // the condition is discarded and the branch is evaluated in place.
+          dirty = true;
+          bool cond = get_immediate(out, 1).test();
+          const auto& code_taken = cond ? altr.code_true : altr.code_false;
+          if(code_taken.empty())
+            continue;
+
+          out.pop_back();
+          out.append(code_taken.begin(), code_taken.end());
+          continue;
+        }
+
+        case index_coalescence: {
+          auto& altr = node.m_stor.as<index_coalescence>();
+          dirty |= do_fold_constants(altr.code_null, fctx);
+          if(altr.assign || !is_immediate(out, 1))
+            break;
+
+          // This is similar to the branch expression above.
+          dirty = true;
+          bool cond = get_immediate(out, 1).is_null();
+          if(!cond || altr.code_null.empty())
+            continue;
+
+          out.pop_back();
+          out.append(altr.code_null.begin(), altr.code_null.end());
+          continue;
+        }
+
+        case index_function_call: {
+          const auto& altr = node.m_stor.as<index_function_call>();
+          if(!fctx.inline_calls)
+            break;
+
+          // Find the node that pushes the target, which precedes all arguments.
+          size_t tpos = out.size();
+          size_t nvals = altr.nargs;
+          while(nvals && tpos) {
+            auto qnops = get_noperands_opt(out[--tpos]);
+            if(!qnops)
+              break;
+            nvals = nvals - 1 + *qnops;
+          }
+          if(nvals || !tpos)
+            break;
+
+          // The target shall be a function that can be inlined.
+          const auto& target = out[--tpos];
+          if(target.index() != index_push_local_reference)
+            break;
+
+          const auto& xref = target.m_stor.as<index_push_local_reference>();
+          if(xref.depth >= frames.size())
+            break;
+
+          auto qdefn = frames[frames.size() - 1 - xref.depth].ptr(xref.name);
+          if(!qdefn || (qdefn->index() != index_define_function))
+            break;
+
+          // Replace the target and the call.
+          // If this is a proper tail call, the result is returned by subsequent nodes,
+          // which are always generated.
+          const auto& defn = qdefn->m_stor.as<index_define_function>();
+          dirty = true;
+          out.erase(tpos, 1);
+          S_inline_call xnode = { altr.sloc, altr.nargs, defn.sloc,
+                                  format_function_signature(defn.func, defn.params),
+                                  defn.params, defn.code_body };
+          node = ::std::move(xnode);
+          break;
+        }
+
+        case index_apply_operator: {
+          const auto& altr = node.m_stor.as<index_apply_operator>();
+          if(altr.assign)
+            break;
+
+          // Operators that yield or modify references don't read their operands
+          // by value.
+          if(::rocket::is_any_of(altr.xop, { xop_inc_post, xop_dec_post, xop_subscr,
+                                             xop_inc_pre, xop_dec_pre, xop_unset,
+                                             xop_assign, xop_head, xop_tail }))
+            break;
+
+          propagate_operands(*get_noperands_opt(node));
+
+          // Evaluate the operator if all of its operands are constants.
+          opt<Value> qval;
+          if(::rocket::is_any_of(altr.xop, { xop_pos, xop_neg, xop_notb, xop_notl })) {
+            if(!is_immediate(out, 1))
+              break;
+
+            qval = do_fold_unary_opt(altr.xop, get_immediate(out, 1));
+            if(!qval)
+              break;
+
+            out.pop_back();
+          }
+          else {
+            if(!is_immediate(out, 1) || !is_immediate(out, 2))
+              break;
+
+            qval = do_fold_binary_opt(altr.xop, get_immediate(out, 2), get_immediate(out, 1));
+            if(!qval)
+              break;
+
+            out.pop_back();
+            out.pop_back();
+          }
+
+          dirty = true;
+          S_push_immediate xnode = { ::std::move(*qval) };
+          node = ::std::move(xnode);
+          break;
+        }
+
+        case index_define_null_variable: {
+          const auto& altr = node.m_stor.as<index_define_null_variable>();
+          frames.mut_back().erase(altr.name);
+          break;
+        }
+
+        case index_defer_expression: {
+          auto& altr = node.m_stor.as<index_defer_expression>();
+
+          // Deferred expressions are evaluated in another context, so don't
+          // propagate anything into them.
+          auto frames_outer = ::std::move(frames);
+          frames.clear();
+          frames.emplace_back();
+          dirty |= do_fold_constants(altr.code_body, fctx);
+          frames = ::std::move(frames_outer);
+          break;
+        }
+
+        case index_declare_reference: {
+          const auto& altr = node.m_stor.as<index_declare_reference>();
+          frames.mut_back().erase(altr.name);
+          break;
+        }
+
+        case index_initialize_reference: {
+          const auto& altr = node.m_stor.as<index_initialize_reference>();
+          frames.mut_back().erase(altr.name);
+          break;
+        }
+
+        case index_inline_call: {
+          // The body has been folded already.
+          const auto& altr = node.m_stor.as<index_inline_call>();
+          fctx.nnodes += altr.code_body.size();
+          break;
+        }
+
+        default:
+          break;
+      }
+      out.emplace_back(::std::move(node));
+    }
+
+    // References to immutable variables that have not been replaced reference
+    // their frames.
+    for(const auto& xnode : out)
+      if(get_constant_opt(xnode)) {
+        size_t depth = xnode.m_stor.as<index_push_local_reference>().depth;
+        fctx.min_frame = ::rocket::min(fctx.min_frame, frames.size() - 1 - depth);
+      }
+
+    if(!dirty)
+      return false;
+
+    code = ::std::move(out);
+    return true;
+  }
+
+bool
+AIR_Node::
+fold_constants(cow_vector<AIR_Node>& code, const Compiler_Options& opts)
+  {
+    Fold_Context fctx;
+    fctx.frames.emplace_back();
+    fctx.inline_calls = opts.optimization_level >= 3;
+    fctx.min_frame = SIZE_MAX;
+    fctx.nnodes = 0;
+    fctx.inlinable = false;
+    return do_fold_constants(code, fctx);
+  }
+
+struct AIR_Node::Escape_Context
+  {
+    // These are names of variables that escape. As shadowed names are not
+    // distinguished, this is conservative.
+    cow_dictionary<bool> escaped;
+
+    // Each element is a set of names of variables that a reference on the
+    // stack may denote.
+    cow_vector<cow_vector<phsh_string>> stack;
+
+    // This is set when the stack is out of sync, in which case all variables
+    // are assumed to escape.
+    bool unknown;
+  };
+
+void
+AIR_Node::
+do_find_escapes(const cow_vector<AIR_Node>& code, Escape_Context& ectx)
+  {
+    auto& stack = ectx.stack;
+
+    auto escape = [&](const cow_vector<phsh_string>& names)
+      {
+        for(const auto& name : names)
+          ectx.escaped.insert_or_assign(name, true);
+      };
+
+    auto pop = [&]
+      {
+        cow_vector<phsh_string> names;
+        if(stack.empty())
+          ectx.unknown = true;
+        else {
+          names = ::std::move(stack.mut_back());
+          stack.pop_back();
+        }
+        return names;
+      };
+
+    // Subexpressions and bodies of statements are simulated on separate stacks.
+    // The set of the reference on the top is returned.
+    auto do_subcode = [&](const cow_vector<AIR_Node>& body)
+      {
+        cow_vector<cow_vector<phsh_string>> saved;
+        saved.swap(stack);
+        do_find_escapes(body, ectx);
+        cow_vector<phsh_string> names;
+        if(!stack.empty())
+          names = ::std::move(stack.mut_back());
+        saved.swap(stack);
+        return names;
+      };
+
+    for(size_t i = 0;  i < code.size();  ++i) {
+      const auto& node = code[i];
+
+      switch(weaken_enum(node.index())) {
+        case index_clear_stack:
+          stack.clear();
+          break;
+
+        case index_execute_block:
+          do_subcode(node.m_stor.as<index_execute_block>().code_body);
+          break;
+
+        case index_declare_variable:
+          stack.emplace_back().emplace_back(node.m_stor.as<index_declare_variable>().name);
+          break;
+
+        case index_initialize_variable:
+          pop();
+          pop();
+          break;
+
+        case index_if_statement: {
+          const auto& altr = node.m_stor.as<index_if_statement>();
+          do_subcode(altr.code_true);
+          do_subcode(altr.code_false);
+          break;
+        }
+
+        case index_switch_statement: {
+          const auto& altr = node.m_stor.as<index_switch_statement>();
+          for(const auto& body : altr.code_labels)
+            do_subcode(body);
+          for(const auto& body : altr.code_bodies)
+            do_subcode(body);
+          break;
+        }
+
+        case index_do_while_statement: {
+          const auto& altr = node.m_stor.as<index_do_while_statement>();
+          do_subcode(altr.code_body);
+          do_subcode(altr.code_cond);
+          break;
+        }
+
+        case index_while_statement: {
+          const auto& altr = node.m_stor.as<index_while_statement>();
+          do_subcode(altr.code_cond);
+          do_subcode(altr.code_body);
+          break;
+        }
+
+        case index_for_each_statement: {
+          const auto& altr = node.m_stor.as<index_for_each_statement>();
+          // Elements of the range are bound to `name_key` and `name_mapped`.
+          escape(do_subcode(altr.code_init));
+          do_subcode(altr.code_body);
+          break;
+        }
+
+        case index_for_statement: {
+          const auto& altr = node.m_stor.as<index_for_statement>();
+          do_subcode(altr.code_init);
+          do_subcode(altr.code_cond);
+          do_subcode(altr.code_step);
+          do_subcode(altr.code_body);
+          break;
+        }
+
+        case index_try_statement: {
+          const auto& altr = node.m_stor.as<index_try_statement>();
+          do_subcode(altr.code_try);
+          do_subcode(altr.code_catch);
+          break;
+        }
+
+        case index_throw_statement:
+        case index_assert_statement:
+        case index_single_step_trap:
+        case index_break_or_continue:
+        case index_declare_reference:
+        case index_define_null_variable:
+          break;
+
+        case index_return_statement:
+          // A variable that is returned by reference escapes.
+          if(node.m_stor.as<index_return_statement>().status == air_status_return_ref)
+            if(!stack.empty())
+              escape(stack.back());
+          break;
+
+        case index_glvalue_to_prvalue:
+          // The result is a temporary value.
+          if(!stack.empty())
+            stack.mut_back().clear();
+          break;
+
+        case index_push_immediate:
+        case index_push_global_reference:
+        case index_push_bound_reference:
+          stack.emplace_back();
+          break;
+
+        case index_push_local_reference:
+          stack.emplace_back().emplace_back(node.m_stor.as<index_push_local_reference>().name);
+          break;
+
+        case index_define_function:
+          // All variables that are referenced by the closure escape.
+          node.do_collect_references(ectx);
+          stack.emplace_back();
+          break;
+
+        case index_branch_expression: {
+          const auto& altr = node.m_stor.as<index_branch_expression>();
+          // The result may be the condition, or the result of either branch.
+          auto names = pop();
+          auto names_true = do_subcode(altr.code_true);
+          names.append(names_true.begin(), names_true.end());
+          auto names_false = do_subcode(altr.code_false);
+          names.append(names_false.begin(), names_false.end());
+          stack.emplace_back(::std::move(names));
+          break;
+        }
+
+        case index_coalescence: {
+          const auto& altr = node.m_stor.as<index_coalescence>();
+          auto names = pop();
+          auto names_null = do_subcode(altr.code_null);
+          names.append(names_null.begin(), names_null.end());
+          stack.emplace_back(::std::move(names));
+          break;
+        }
+
+        case index_function_call: {
+          const auto& altr = node.m_stor.as<index_function_call>();
+          // Arguments are passed by reference, and the target may be bound to
+          // `this`, so all of them escape.
+          for(uint32_t k = 0;  k != altr.nargs + 1;  ++k)
+            escape(pop());
+          stack.emplace_back();
+          break;
+        }
+
+        case index_member_access:
+          break;
+
+        case index_push_unnamed_array: {
+          const auto& altr = node.m_stor.as<index_push_unnamed_array>();
+          for(uint32_t k = 0;  k != altr.nelems;  ++k)
+            pop();
+          stack.emplace_back();
+          break;
+        }
+
+        case index_push_unnamed_object: {
+          const auto& altr = node.m_stor.as<index_push_unnamed_object>();
+          for(size_t k = 0;  k != altr.keys.size();  ++k)
+            pop();
+          stack.emplace_back();
+          break;
+        }
+
+        case index_apply_operator: {
+          const auto& altr = node.m_stor.as<index_apply_operator>();
+          // Binary operators pop the right-hand operand. The result is a reference
+          // to the left-hand operand only if it is modified in place.
+          bool glvalue = altr.assign;
+          switch(weaken_enum(altr.xop)) {
+            case xop_subscr:
+            case xop_assign:
+              glvalue = true;
+              pop();
+              break;
+
+            case xop_cmp_eq:
+            case xop_cmp_ne:
+            case xop_cmp_lt:
+            case xop_cmp_gt:
+            case xop_cmp_lte:
+            case xop_cmp_gte:
+            case xop_cmp_3way:
+            case xop_add:
+            case xop_sub:
+            case xop_mul:
+            case xop_div:
+            case xop_mod:
+            case xop_sll:
+            case xop_srl:
+            case xop_sla:
+            case xop_sra:
+            case xop_andb:
+            case xop_orb:
+            case xop_xorb:
+              pop();
+              break;
+
+            case xop_fma:
+              pop();
+              pop();
+              break;
+
+            case xop_inc_pre:
+            case xop_dec_pre:
+            case xop_head:
+            case xop_tail:
+              glvalue = true;
+              break;
+
+            default:
+              break;
+          }
+          if(!glvalue && !stack.empty())
+            stack.mut_back().clear();
+          break;
+        }
+
+        case index_unpack_struct_array: {
+          const auto& altr = node.m_stor.as<index_unpack_struct_array>();
+          for(uint32_t k = 0;  k != altr.nelems + 1;  ++k)
+            pop();
+          break;
+        }
+
+        case index_unpack_struct_object: {
+          const auto& altr = node.m_stor.as<index_unpack_struct_object>();
+          for(size_t k = 0;  k != altr.keys.size() + 1;  ++k)
+            pop();
+          break;
+        }
+
+        case index_variadic_call:
+          escape(pop());
+          escape(pop());
+          stack.emplace_back();
+          break;
+
+        case index_defer_expression:
+          do_subcode(node.m_stor.as<index_defer_expression>().code_body);
+          break;
+
+        case index_import_call: {
+          const auto& altr = node.m_stor.as<index_import_call>();
+          for(uint32_t k = 0;  k != altr.nargs;  ++k)
+            escape(pop());
+          stack.emplace_back();
+          break;
+        }
+
+        case index_initialize_reference:
+          // The variable is aliased by another name.
+          escape(pop());
+          break;
+
+        case index_inline_call: {
+          const auto& altr = node.m_stor.as<index_inline_call>();
+          // The body is executed in its own context, but arguments are still
+          // passed by reference.
+          for(uint32_t k = 0;  k != altr.nargs;  ++k)
+            escape(pop());
+          stack.emplace_back();
+          break;
+        }
+
+        default:
+          ASTERIA_TERMINATE("invalid AIR node type (index `$1`)", node.index());
+      }
+    }
+  }
+
+void
+AIR_Node::
+do_collect_references(Escape_Context& ectx)
+  const
+  {
+    auto do_collect = [&](const cow_vector<AIR_Node>& body)
+      {
+        for(const auto& node : body)
+          node.do_collect_references(ectx);
+      };
+
+    switch(weaken_enum(this->index())) {
+      case index_push_local_reference: {
+        const auto& altr = this->m_stor.as<index_push_local_reference>();
+        ectx.escaped.insert_or_assign(altr.name, true);
+        return;
+      }
+
+      case index_execute_block:
+        do_collect(this->m_stor.as<index_execute_block>().code_body);
+        return;
+
+      case index_if_statement: {
+        const auto& altr = this->m_stor.as<index_if_statement>();
+        do_collect(altr.code_true);
+        do_collect(altr.code_false);
+        return;
+      }
+
+      case index_switch_statement: {
+        const auto& altr = this->m_stor.as<index_switch_statement>();
+        for(const auto& body : altr.code_labels)
+          do_collect(body);
+        for(const auto& body : altr.code_bodies)
+          do_collect(body);
+        return;
+      }
+
+      case index_do_while_statement: {
+        const auto& altr = this->m_stor.as<index_do_while_statement>();
+        do_collect(altr.code_body);
+        do_collect(altr.code_cond);
+        return;
+      }
+
+      case index_while_statement: {
+        const auto& altr = this->m_stor.as<index_while_statement>();
+        do_collect(altr.code_cond);
+        do_collect(altr.code_body);
+        return;
+      }
+
+      case index_for_each_statement: {
+        const auto& altr = this->m_stor.as<index_for_each_statement>();
+        do_collect(altr.code_init);
+        do_collect(altr.code_body);
+        return;
+      }
+
+      case index_for_statement: {
+        const auto& altr = this->m_stor.as<index_for_statement>();
+        do_collect(altr.code_init);
+        do_collect(altr.code_cond);
+        do_collect(altr.code_step);
+        do_collect(altr.code_body);
+        return;
+      }
+
+      case index_try_statement: {
+        const auto& altr = this->m_stor.as<index_try_statement>();
+        do_collect(altr.code_try);
+        do_collect(altr.code_catch);
+        return;
+      }
+
+      case index_define_function:
+        do_collect(this->m_stor.as<index_define_function>().code_body);
+        return;
+
+      case index_branch_expression: {
+        const auto& altr = this->m_stor.as<index_branch_expression>();
+        do_collect(altr.code_true);
+        do_collect(altr.code_false);
+        return;
+      }
+
+      case index_coalescence:
+        do_collect(this->m_stor.as<index_coalescence>().code_null);
+        return;
+
+      case index_defer_expression:
+        do_collect(this->m_stor.as<index_defer_expression>().code_body);
+        return;
+
+      case index_inline_call:
+        do_collect(this->m_stor.as<index_inline_call>().code_body);
+        return;
+
+      default:
+        return;
+    }
+  }
+
+void
+AIR_Node::
+do_mark_untracked(cow_vector<AIR_Node>& code, const Escape_Context& ectx)
+  {
+    auto untracked = [&](const phsh_string& name)
+      { return !ectx.unknown && (ectx.escaped.count(name) == 0);  };
+
+    for(size_t i = 0;  i < code.size();  ++i) {
+      auto& node = code.mut(i);
+
+      switch(weaken_enum(node.index())) {
+        case index_declare_variable: {
+          auto& altr = node.m_stor.as<index_declare_variable>();
+          altr.untracked = untracked(altr.name);
+          break;
+        }
+
+        case index_define_null_variable: {
+          auto& altr = node.m_stor.as<index_define_null_variable>();
+          altr.untracked = untracked(altr.name);
+          break;
+        }
+
+        case index_execute_block:
+          do_mark_untracked(node.m_stor.as<index_execute_block>().code_body, ectx);
+          break;
+
+        case index_if_statement: {
+          auto& altr = node.m_stor.as<index_if_statement>();
+          do_mark_untracked(altr.code_true, ectx);
+          do_mark_untracked(altr.code_false, ectx);
+          break;
+        }
+
+        case index_switch_statement: {
+          auto& altr = node.m_stor.as<index_switch_statement>();
+          for(size_t k = 0;  k != altr.code_bodies.size();  ++k)
+            do_mark_untracked(altr.code_bodies.mut(k), ectx);
+          break;
+        }
+
+        case index_do_while_statement:
+          do_mark_untracked(node.m_stor.as<index_do_while_statement>().code_body, ectx);
+          break;
+
+        case index_while_statement:
+          do_mark_untracked(node.m_stor.as<index_while_statement>().code_body, ectx);
+          break;
+
+        case index_for_each_statement:
+          do_mark_untracked(node.m_stor.as<index_for_each_statement>().code_body, ectx);
+          break;
+
+        case index_for_statement: {
+          auto& altr = node.m_stor.as<index_for_statement>();
+          do_mark_untracked(altr.code_init, ectx);
+          do_mark_untracked(altr.code_body, ectx);
+          break;
+        }
+
+        case index_try_statement: {
+          auto& altr = node.m_stor.as<index_try_statement>();
+          do_mark_untracked(altr.code_try, ectx);
+          do_mark_untracked(altr.code_catch, ectx);
+          break;
+        }
+
+        default:
+          break;
+      }
+    }
+  }
+
+void
+AIR_Node::
+mark_untracked_variables(cow_vector<AIR_Node>& code)
+  {
+    Escape_Context ectx;
+    ectx.unknown = false;
+    do_find_escapes(code, ectx);
+    do_mark_untracked(code, ectx);
+  }
+
+namespace {
+
+// This is the version of serialized AIR data. It shall be incremented whenever
+// any node is changed.
+constexpr uint32_t air_serial_version = 2;
+
+}  // namespace
+
+struct AIR_Node::Writer
+  {
+    cow_string& data;
+    cow_dictionary<uint32_t> strings;  // indices of strings that have been written
+    bool okay = true;  // whether all nodes can be serialized
+
+    explicit
+    Writer(cow_string& xdata)
+      noexcept
+      : data(xdata)
+      { }
+
+    void
+    put_byte(uint8_t value)
+      { this->data.push_back(static_cast<char>(value));  }
+
+    void
+    put_varint(uint64_t value)
+      {
+        while(value >= 0x80) {
+          this->put_byte(static_cast<uint8_t>(value | 0x80));
+          value >>= 7;
+        }
+        this->put_byte(static_cast<uint8_t>(value));
+      }
+
+    void
+    put(bool value)
+      { this->put_byte(value);  }
+
+    void
+    put(uint32_t value)
+      { this->put_varint(value);  }
+
+    void
+    put(int64_t value)
+      { this->put_varint(static_cast<uint64_t>(value) << 1 ^ static_cast<uint64_t>(value >> 63));  }
+
+    void
+    put(int value)
+      { this->put(static_cast<int64_t>(value));  }
+
+    void
+    put(double value)
+      {
+        char bytes[sizeof(value)];
+        ::std::memcpy(bytes, &value, sizeof(value));
+        this->data.append(bytes, sizeof(value));
+      }
+
+    void
+    put(AIR_Status value)
+      { this->put_byte(value);  }
+
+    void
+    put(PTC_Aware value)
+      { this->put_byte(static_cast<uint8_t>(value));  }
+
+    void
+    put(Xop value)
+      { this->put_byte(value);  }
+
+    void
+    put(const phsh_string& str)
+      {
+        // Each distinct string is written only once. Subsequent occurrences are
+        // written as indices into the list of strings that have been written.
+        uint32_t index = static_cast<uint32_t>(this->strings.size());
+        auto pair = this->strings.try_emplace(str, index);
+        this->put_varint(pair.first->second);
+        if(!pair.second)
+          return;
+
+        this->put_varint(str.size());
+        this->data.append(str.data(), str.size());
+      }
+
+    void
+    put(const cow_string& str)
+      { this->put(phsh_string(str));  }
+
+    void
+    put(const Source_Location& sloc)
+      {
+        this->put(sloc.file());
+        this->put(sloc.line());
+        this->put(sloc.offset());
+      }
+
+    void
+    put(const Compiler_Options& opts)
+      {
+        // Keep this in sync with `Reader::get(Compiler_Options&)`.
+        this->put_byte(opts.version);
+        this->put(opts.escapable_single_quotes);
+        this->put(opts.keywords_as_identifiers);
+        this->put(opts.integers_as_reals);
+        this->put(opts.proper_tail_calls);
+        this->put(opts.verbose_single_step_traps);
+        this->put_byte(static_cast<uint8_t>(opts.optimization_level));
+      }
+
+    void
+    put(const Value& value)
+      {
+        this->put_byte(value.type());
+        switch(weaken_enum(value.type())) {
+          case type_null:
+            return;
+
+          case type_boolean:
+            return this->put(value.as_boolean());
+
+          case type_integer:
+            return this->put(value.as_integer());
+
+          case type_real:
+            return this->put(value.as_real());
+
+          case type_string:
+            return this->put(value.as_string());
+
+          case type_array:
+            return this->put(value.as_array());
+
+          case type_object: {
+            const auto& obj = value.as_object();
+            this->put_varint(obj.size());
+            for(auto it = obj.begin();  it != obj.end();  ++it) {
+              this->put(it->first);
+              this->put(it->second);
+            }
+            return;
+          }
+
+          default:
+            // Opaque values and functions only exist at runtime.
+            this->okay = false;
+            return;
+        }
+      }
+
+    void
+    put(const Reference& /*ref*/)
+      {
+        // Bound references only exist at runtime.
+        this->okay = false;
+      }
+
+    void
+    put(const AIR_Node& node)
+      { node.do_serialize(*this);  }
+
+    template<typename XElemT>
+    void
+    put(const cow_vector<XElemT>& vec)
+      {
+        this->put_varint(vec.size());
+        for(const auto& elem : vec)
+          this->put(elem);
+      }
+  };
+
+struct AIR_Node::Reader
+  {
+    const unsigned char* bptr;
+    const unsigned char* eptr;
+    const unsigned char* base;  // for error messages
+    cow_vector<phsh_string> strings;  // strings that have been read
+
+    explicit
+    Reader(const void* data, size_t size)
+      noexcept
+      : bptr(static_cast<const unsigned char*>(data)), eptr(bptr + size), base(bptr)
+      { }
+
+    [[noreturn]]
+    void
+    throw_invalid()
+      const
+      {
+        ASTERIA_THROW("Invalid AIR data (offset `$1`)", this->bptr - this->base);
+      }
+
+    size_t
+    get_size(size_t min_elem_size)
+      {
+        // Reject sizes that can't possibly fit in the remaining data.
+        auto value = this->get_varint();
+        if(value > static_cast<size_t>(this->eptr - this->bptr) / min_elem_size)
+          this->throw_invalid();
+        return static_cast<size_t>(value);
+      }
 
-        return do_rebind_return_opt(dirty, ::std::move(bound));
+    uint8_t
+    get_byte()
+      {
+        if(this->bptr == this->eptr)
+          this->throw_invalid();
+        return *(this->bptr++);
       }
 
-      case index_coalescence: {
-        const auto& altr = this->m_stor.as<index_coalescence>();
+    uint64_t
+    get_varint()
+      {
+        uint64_t value = 0;
+        for(uint32_t shift = 0;  shift < 64;  shift += 7) {
+          uint8_t byte = this->get_byte();
+          value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+          if(!(byte & 0x80))
+            return value;
+        }
+        this->throw_invalid();
+      }
 
-        // Rebind the expression.
-        bool dirty = false;
-        auto bound = altr;
+    void
+    get(bool& value)
+      {
+        uint8_t byte = this->get_byte();
+        if(byte > 1)
+          this->throw_invalid();
+        value = byte;
+      }
 
-        do_rebind_nodes(dirty, bound.code_null, ctx);
+    void
+    get(uint32_t& value)
+      {
+        auto temp = this->get_varint();
+        if(temp > UINT32_MAX)
+          this->throw_invalid();
+        value = static_cast<uint32_t>(temp);
+      }
 
-        return do_rebind_return_opt(dirty, ::std::move(bound));
+    void
+    get(int64_t& value)
+      {
+        auto temp = this->get_varint();
+        value = static_cast<int64_t>(temp >> 1 ^ (0 - (temp & 1)));
       }
 
-      case index_function_call:
-      case index_member_access:
-      case index_push_unnamed_array:
-      case index_push_unnamed_object:
-      case index_apply_operator:
-      case index_unpack_struct_array:
-      case index_unpack_struct_object:
-      case index_define_null_variable:
-      case index_single_step_trap:
-      case index_variadic_call:
-        // There is nothing to rebind.
-        return nullopt;
+    void
+    get(int& value)
+      {
+        int64_t temp;
+        this->get(temp);
+        if((temp < INT_MIN) || (temp > INT_MAX))
+          this->throw_invalid();
+        value = static_cast<int>(temp);
+      }
 
-      case index_defer_expression: {
-        const auto& altr = this->m_stor.as<index_defer_expression>();
+    void
+    get(double& value)
+      {
+        if(this->eptr - this->bptr < static_cast<ptrdiff_t>(sizeof(value)))
+          this->throw_invalid();
+        ::std::memcpy(&value, this->bptr, sizeof(value));
+        this->bptr += sizeof(value);
+      }
 
-        // Rebind the expression.
-        bool dirty = false;
-        auto bound = altr;
+    void
+    get(AIR_Status& value)
+      {
+        uint8_t byte = this->get_byte();
+        if(byte > air_status_continue_for)
+          this->throw_invalid();
+        value = static_cast<AIR_Status>(byte);
+      }
 
-        do_rebind_nodes(dirty, bound.code_body, ctx);
+    void
+    get(PTC_Aware& value)
+      {
+        // This is a bitmask, so values are not contiguous.
+        auto temp = static_cast<PTC_Aware>(this->get_byte());
+        switch(temp) {
+          case ptc_aware_none:
+          case ptc_aware_void:
+          case ptc_aware_by_ref:
+          case ptc_aware_by_val:
+            value = temp;
+            return;
 
-        return do_rebind_return_opt(dirty, ::std::move(bound));
+          default:
+            this->throw_invalid();
+        }
       }
 
-      case index_import_call:
-      case index_break_or_continue:
-      case index_declare_reference:
-      case index_initialize_reference:
-        // There is nothing to rebind.
-        return nullopt;
+    void
+    get(Xop& value)
+      {
+        uint8_t byte = this->get_byte();
+        if(byte > xop_tail)
+          this->throw_invalid();
+        value = static_cast<Xop>(byte);
+      }
 
-      default:
-        ASTERIA_TERMINATE("invalid AIR node type (index `$1`)", this->index());
-    }
-  }
+    void
+    get(phsh_string& str)
+      {
+        auto index = this->get_varint();
+        if(index < this->strings.size()) {
+          str = this->strings[static_cast<size_t>(index)];
+          return;
+        }
+        if(index != this->strings.size())
+          this->throw_invalid();
 
-bool
-AIR_Node::
-solidify(AVMC_Queue& queue)
-  const
-  {
-    switch(this->index()) {
-      case index_clear_stack:
-        return do_solidify<AIR_Traits_clear_stack>(queue,
-                                     this->m_stor.as<index_clear_stack>());
+        // This is a new string.
+        size_t len = this->get_size(1);
+        str = phsh_string(cow_string(reinterpret_cast<const char*>(this->bptr), len));
+        this->bptr += len;
+        this->strings.emplace_back(str);
+      }
 
-      case index_execute_block:
-        return do_solidify<AIR_Traits_execute_block>(queue,
-                                     this->m_stor.as<index_execute_block>());
+    void
+    get(cow_string& str)
+      {
+        phsh_string temp;
+        this->get(temp);
+        str = temp.rdstr();
+      }
 
-      case index_declare_variable:
-        return do_solidify<AIR_Traits_declare_variable>(queue,
-                                     this->m_stor.as<index_declare_variable>());
+    void
+    get(Source_Location& sloc)
+      {
+        cow_string file;
+        int line, offset;
+        this->get(file);
+        this->get(line);
+        this->get(offset);
+        sloc = Source_Location(file, line, offset);
+      }
 
-      case index_initialize_variable:
-        return do_solidify<AIR_Traits_initialize_variable>(queue,
-                                     this->m_stor.as<index_initialize_variable>());
+    void
+    get(Compiler_Options& opts)
+      {
+        // Read fields one by one, so invalid values can't sneak into `bool`s.
+        if(this->get_byte() != opts.version)
+          this->throw_invalid();
+        this->get(opts.escapable_single_quotes);
+        this->get(opts.keywords_as_identifiers);
+        this->get(opts.integers_as_reals);
+        this->get(opts.proper_tail_calls);
+        this->get(opts.verbose_single_step_traps);
+        opts.optimization_level = static_cast<int8_t>(this->get_byte());
+      }
 
-      case index_if_statement:
-        return do_solidify<AIR_Traits_if_statement>(queue,
-                                     this->m_stor.as<index_if_statement>());
+    void
+    get(Value& value)
+      {
+        switch(this->get_byte()) {
+          case type_null:
+            value = nullopt;
+            return;
+
+          case type_boolean: {
+            V_boolean val;
+            this->get(val);
+            value = val;
+            return;
+          }
 
-      case index_switch_statement:
-        return do_solidify<AIR_Traits_switch_statement>(queue,
-                                     this->m_stor.as<index_switch_statement>());
+          case type_integer: {
+            V_integer val;
+            this->get(val);
+            value = val;
+            return;
+          }
 
-      case index_do_while_statement:
-        return do_solidify<AIR_Traits_do_while_statement>(queue,
-                                     this->m_stor.as<index_do_while_statement>());
+          case type_real: {
+            V_real val;
+            this->get(val);
+            value = val;
+            return;
+          }
 
-      case index_while_statement:
-        return do_solidify<AIR_Traits_while_statement>(queue,
-                                     this->m_stor.as<index_while_statement>());
+          case type_string: {
+            V_string val;
+            this->get(val);
+            value = ::std::move(val);
+            return;
+          }
 
-      case index_for_each_statement:
-        return do_solidify<AIR_Traits_for_each_statement>(queue,
-                                     this->m_stor.as<index_for_each_statement>());
+          case type_array: {
+            V_array val;
+            this->get(val);
+            value = ::std::move(val);
+            return;
+          }
 
-      case index_for_statement:
-        return do_solidify<AIR_Traits_for_statement>(queue,
-                                     this->m_stor.as<index_for_statement>());
+          case type_object: {
+            V_object val;
+            size_t size = this->get_size(2);
+            for(size_t k = 0;  k != size;  ++k) {
+              phsh_string key;
+              Value elem;
+              this->get(key);
+              this->get(elem);
+              val.insert_or_assign(::std::move(key), ::std::move(elem));
+            }
+            value = ::std::move(val);
+            return;
+          }
 
-      case index_try_statement:
-        return do_solidify<AIR_Traits_try_statement>(queue,
-                                     this->m_stor.as<index_try_statement>());
+          default:
+            this->throw_invalid();
+        }
+      }
 
-      case index_throw_statement:
-        return do_solidify<AIR_Traits_throw_statement>(queue,
-                                     this->m_stor.as<index_throw_statement>());
+    void
+    get(Reference& /*ref*/)
+      {
+        // Bound references are never serialized.
+        this->throw_invalid();
+      }
 
-      case index_assert_statement:
-        return do_solidify<AIR_Traits_assert_statement>(queue,
-                                     this->m_stor.as<index_assert_statement>());
+    void
+    get(cow_vector<AIR_Node>& code)
+      {
+        size_t size = this->get_size(1);
+        code.clear();
+        code.reserve(size);
+        for(size_t k = 0;  k != size;  ++k)
+          code.emplace_back(AIR_Node::do_deserialize(*this));
+      }
 
-      case index_return_statement:
-        return do_solidify<AIR_Traits_return_statement>(queue,
-                                     this->m_stor.as<index_return_statement>());
+    template<typename XElemT>
+    void
+    get(cow_vector<XElemT>& vec)
+      {
+        size_t size = this->get_size(1);
+        vec.clear();
+        vec.reserve(size);
+        for(size_t k = 0;  k != size;  ++k)
+          this->get(vec.emplace_back());
+      }
+  };
 
-      case index_glvalue_to_prvalue:
-        return do_solidify<AIR_Traits_glvalue_to_prvalue>(queue,
-                                     this->m_stor.as<index_glvalue_to_prvalue>());
+void
+AIR_Node::
+do_serialize(Writer& writer)
+  const
+  {
+    writer.put_byte(this->index());
+    switch(this->index()) {
+      case index_clear_stack:
+        return;
 
-      case index_push_immediate: {
-        const auto& altr = this->m_stor.as<index_push_immediate>();
-        switch(weaken_enum(altr.value.type())) {
-          case type_null:
-            return do_solidify<AIR_Traits_push_immediate_null>(queue, altr);
+      case index_execute_block: {
+        const auto& altr = this->m_stor.as<index_execute_block>();
+        writer.put(altr.code_body);
+        return;
+      }
 
-          case type_boolean:
-            return do_solidify<AIR_Traits_push_immediate_boolean>(queue, altr);
+      case index_declare_variable: {
+        const auto& altr = this->m_stor.as<index_declare_variable>();
+        writer.put(altr.sloc);
+        writer.put(altr.name);
+        writer.put(altr.untracked);
+        return;
+      }
 
-          case type_integer:
-            if(do_is_int48(altr.value.as_integer()))
-              return do_solidify<AIR_Traits_push_immediate_int48>(queue, altr);
-            else
-              // Fallthrough
-          default:
-              return do_solidify<AIR_Traits_push_immediate_generic>(queue, altr);
-        }
+      case index_initialize_variable: {
+        const auto& altr = this->m_stor.as<index_initialize_variable>();
+        writer.put(altr.sloc);
+        writer.put(altr.immutable);
+        return;
       }
 
-      case index_push_global_reference:
-        return do_solidify<AIR_Traits_push_global_reference>(queue,
-                                     this->m_stor.as<index_push_global_reference>());
+      case index_if_statement: {
+        const auto& altr = this->m_stor.as<index_if_statement>();
+        writer.put(altr.negative);
+        writer.put(altr.code_true);
+        writer.put(altr.code_false);
+        return;
+      }
 
-      case index_push_local_reference:
-        return do_solidify<AIR_Traits_push_local_reference>(queue,
-                                     this->m_stor.as<index_push_local_reference>());
+      case index_switch_statement: {
+        const auto& altr = this->m_stor.as<index_switch_statement>();
+        writer.put(altr.code_labels);
+        writer.put(altr.code_bodies);
+        writer.put(altr.names_added);
+        return;
+      }
 
-      case index_push_bound_reference:
-        return do_solidify<AIR_Traits_push_bound_reference>(queue,
-                                     this->m_stor.as<index_push_bound_reference>());
+      case index_do_while_statement: {
+        const auto& altr = this->m_stor.as<index_do_while_statement>();
+        writer.put(altr.code_body);
+        writer.put(altr.negative);
+        writer.put(altr.code_cond);
+        return;
+      }
 
-      case index_define_function:
-        return do_solidify<AIR_Traits_define_function>(queue,
-                                     this->m_stor.as<index_define_function>());
+      case index_while_statement: {
+        const auto& altr = this->m_stor.as<index_while_statement>();
+        writer.put(altr.negative);
+        writer.put(altr.code_cond);
+        writer.put(altr.code_body);
+        return;
+      }
 
-      case index_branch_expression:
-        return do_solidify<AIR_Traits_branch_expression>(queue,
-                                     this->m_stor.as<index_branch_expression>());
+      case index_for_each_statement: {
+        const auto& altr = this->m_stor.as<index_for_each_statement>();
+        writer.put(altr.name_key);
+        writer.put(altr.name_mapped);
+        writer.put(altr.code_init);
+        writer.put(altr.code_body);
+        return;
+      }
 
-      case index_coalescence:
-        return do_solidify<AIR_Traits_coalescence>(queue,
-                                     this->m_stor.as<index_coalescence>());
+      case index_for_statement: {
+        const auto& altr = this->m_stor.as<index_for_statement>();
+        writer.put(altr.code_init);
+        writer.put(altr.code_cond);
+        writer.put(altr.code_step);
+        writer.put(altr.code_body);
+        return;
+      }
 
-      case index_function_call:
-        return do_solidify<AIR_Traits_function_call>(queue,
-                                     this->m_stor.as<index_function_call>());
+      case index_try_statement: {
+        const auto& altr = this->m_stor.as<index_try_statement>();
+        writer.put(altr.sloc_try);
+        writer.put(altr.code_try);
+        writer.put(altr.sloc_catch);
+        writer.put(altr.name_except);
+        writer.put(altr.code_catch);
+        return;
+      }
 
-      case index_member_access:
-        return do_solidify<AIR_Traits_member_access>(queue,
-                                     this->m_stor.as<index_member_access>());
+      case index_throw_statement: {
+        const auto& altr = this->m_stor.as<index_throw_statement>();
+        writer.put(altr.sloc);
+        return;
+      }
 
-      case index_push_unnamed_array:
-        return do_solidify<AIR_Traits_push_unnamed_array>(queue,
-                                     this->m_stor.as<index_push_unnamed_array>());
+      case index_assert_statement: {
+        const auto& altr = this->m_stor.as<index_assert_statement>();
+        writer.put(altr.sloc);
+        writer.put(altr.negative);
+        writer.put(altr.msg);
+        return;
+      }
 
-      case index_push_unnamed_object:
-        return do_solidify<AIR_Traits_push_unnamed_object>(queue,
-                                     this->m_stor.as<index_push_unnamed_object>());
+      case index_return_statement: {
+        const auto& altr = this->m_stor.as<index_return_statement>();
+        writer.put(altr.status);
+        return;
+      }
 
-      case index_apply_operator: {
-        const auto& altr = this->m_stor.as<index_apply_operator>();
-        switch(altr.xop) {
-          case xop_inc_post:
-            return do_solidify<AIR_Traits_apply_operator_inc_post>(queue, altr);
+      case index_glvalue_to_prvalue: {
+        const auto& altr = this->m_stor.as<index_glvalue_to_prvalue>();
+        writer.put(altr.sloc);
+        return;
+      }
 
-          case xop_dec_post:
-            return do_solidify<AIR_Traits_apply_operator_dec_post>(queue, altr);
+      case index_push_immediate: {
+        const auto& altr = this->m_stor.as<index_push_immediate>();
+        writer.put(altr.value);
+        return;
+      }
+
+      case index_push_global_reference: {
+        const auto& altr = this->m_stor.as<index_push_global_reference>();
+        writer.put(altr.sloc);
+        writer.put(altr.name);
+        return;
+      }
+
+      case index_push_local_reference: {
+        const auto& altr = this->m_stor.as<index_push_local_reference>();
+        writer.put(altr.sloc);
+        writer.put(altr.depth);
+        writer.put(altr.name);
+        writer.put(altr.slot);
+        return;
+      }
+
+      case index_push_bound_reference: {
+        const auto& altr = this->m_stor.as<index_push_bound_reference>();
+        writer.put(altr.ref);
+        return;
+      }
 
-          case xop_subscr:
-            return do_solidify<AIR_Traits_apply_operator_subscr>(queue, altr);
+      case index_define_function: {
+        const auto& altr = this->m_stor.as<index_define_function>();
+        writer.put(altr.opts);
+        writer.put(altr.sloc);
+        writer.put(altr.func);
+        writer.put(altr.params);
+        writer.put(altr.code_body);
+        return;
+      }
 
-          case xop_pos:
-            return do_solidify<AIR_Traits_apply_operator_pos>(queue, altr);
+      case index_branch_expression: {
+        const auto& altr = this->m_stor.as<index_branch_expression>();
+        writer.put(altr.sloc);
+        writer.put(altr.code_true);
+        writer.put(altr.code_false);
+        writer.put(altr.assign);
+        return;
+      }
 
-          case xop_neg:
-            return do_solidify<AIR_Traits_apply_operator_neg>(queue, altr);
+      case index_coalescence: {
+        const auto& altr = this->m_stor.as<index_coalescence>();
+        writer.put(altr.sloc);
+        writer.put(altr.code_null);
+        writer.put(altr.assign);
+        return;
+      }
 
-          case xop_notb:
-            return do_solidify<AIR_Traits_apply_operator_notb>(queue, altr);
+      case index_function_call: {
+        const auto& altr = this->m_stor.as<index_function_call>();
+        writer.put(altr.sloc);
+        writer.put(altr.nargs);
+        writer.put(altr.ptc);
+        return;
+      }
 
-          case xop_notl:
-            return do_solidify<AIR_Traits_apply_operator_notl>(queue, altr);
+      case index_member_access: {
+        const auto& altr = this->m_stor.as<index_member_access>();
+        writer.put(altr.sloc);
+        writer.put(altr.name);
+        return;
+      }
 
-          case xop_inc_pre:
-            return do_solidify<AIR_Traits_apply_operator_inc_pre>(queue, altr);
+      case index_push_unnamed_array: {
+        const auto& altr = this->m_stor.as<index_push_unnamed_array>();
+        writer.put(altr.sloc);
+        writer.put(altr.nelems);
+        return;
+      }
 
-          case xop_dec_pre:
-            return do_solidify<AIR_Traits_apply_operator_dec_pre>(queue, altr);
+      case index_push_unnamed_object: {
+        const auto& altr = this->m_stor.as<index_push_unnamed_object>();
+        writer.put(altr.sloc);
+        writer.put(altr.keys);
+        return;
+      }
 
-          case xop_unset:
-            return do_solidify<AIR_Traits_apply_operator_unset>(queue, altr);
+      case index_apply_operator: {
+        const auto& altr = this->m_stor.as<index_apply_operator>();
+        writer.put(altr.sloc);
+        writer.put(altr.xop);
+        writer.put(altr.assign);
+        return;
+      }
 
-          case xop_countof:
-            return do_solidify<AIR_Traits_apply_operator_countof>(queue, altr);
+      case index_unpack_struct_array: {
+        const auto& altr = this->m_stor.as<index_unpack_struct_array>();
+        writer.put(altr.sloc);
+        writer.put(altr.immutable);
+        writer.put(altr.nelems);
+        return;
+      }
 
-          case xop_typeof:
-            return do_solidify<AIR_Traits_apply_operator_typeof>(queue, altr);
+      case index_unpack_struct_object: {
+        const auto& altr = this->m_stor.as<index_unpack_struct_object>();
+        writer.put(altr.sloc);
+        writer.put(altr.immutable);
+        writer.put(altr.keys);
+        return;
+      }
 
-          case xop_sqrt:
-            return do_solidify<AIR_Traits_apply_operator_sqrt>(queue, altr);
+      case index_define_null_variable: {
+        const auto& altr = this->m_stor.as<index_define_null_variable>();
+        writer.put(altr.immutable);
+        writer.put(altr.sloc);
+        writer.put(altr.name);
+        writer.put(altr.untracked);
+        return;
+      }
 
-          case xop_isnan:
-            return do_solidify<AIR_Traits_apply_operator_isnan>(queue, altr);
+      case index_single_step_trap: {
+        const auto& altr = this->m_stor.as<index_single_step_trap>();
+        writer.put(altr.sloc);
+        return;
+      }
 
-          case xop_isinf:
-            return do_solidify<AIR_Traits_apply_operator_isinf>(queue, altr);
+      case index_variadic_call: {
+        const auto& altr = this->m_stor.as<index_variadic_call>();
+        writer.put(altr.sloc);
+        writer.put(altr.ptc);
+        return;
+      }
 
-          case xop_abs:
-            return do_solidify<AIR_Traits_apply_operator_abs>(queue, altr);
+      case index_defer_expression: {
+        const auto& altr = this->m_stor.as<index_defer_expression>();
+        writer.put(altr.sloc);
+        writer.put(altr.code_body);
+        return;
+      }
 
-          case xop_sign:
-            return do_solidify<AIR_Traits_apply_operator_sign>(queue, altr);
+      case index_import_call: {
+        const auto& altr = this->m_stor.as<index_import_call>();
+        writer.put(altr.opts);
+        writer.put(altr.sloc);
+        writer.put(altr.nargs);
+        return;
+      }
 
-          case xop_round:
-            return do_solidify<AIR_Traits_apply_operator_round>(queue, altr);
+      case index_break_or_continue: {
+        const auto& altr = this->m_stor.as<index_break_or_continue>();
+        writer.put(altr.sloc);
+        writer.put(altr.status);
+        return;
+      }
 
-          case xop_floor:
-            return do_solidify<AIR_Traits_apply_operator_floor>(queue, altr);
+      case index_declare_reference: {
+        const auto& altr = this->m_stor.as<index_declare_reference>();
+        writer.put(altr.name);
+        return;
+      }
 
-          case xop_ceil:
-            return do_solidify<AIR_Traits_apply_operator_ceil>(queue, altr);
+      case index_initialize_reference: {
+        const auto& altr = this->m_stor.as<index_initialize_reference>();
+        writer.put(altr.sloc);
+        writer.put(altr.name);
+        return;
+      }
 
-          case xop_trunc:
-            return do_solidify<AIR_Traits_apply_operator_trunc>(queue, altr);
+      case index_inline_call: {
+        const auto& altr = this->m_stor.as<index_inline_call>();
+        writer.put(altr.sloc);
+        writer.put(altr.nargs);
+        writer.put(altr.sloc_func);
+        writer.put(altr.func);
+        writer.put(altr.params);
+        writer.put(altr.code_body);
+        return;
+      }
 
-          case xop_iround:
-            return do_solidify<AIR_Traits_apply_operator_iround>(queue, altr);
+      default:
+        ASTERIA_TERMINATE("invalid AIR node type (index `$1`)", this->index());
+    }
+  }
 
-          case xop_ifloor:
-            return do_solidify<AIR_Traits_apply_operator_ifloor>(queue, altr);
+AIR_Node
+AIR_Node::
+do_deserialize(Reader& reader)
+  {
+    switch(reader.get_byte()) {
+      case index_clear_stack: {
+        S_clear_stack xnode;
+        return ::std::move(xnode);
+      }
 
-          case xop_iceil:
-            return do_solidify<AIR_Traits_apply_operator_iceil>(queue, altr);
+      case index_execute_block: {
+        S_execute_block xnode;
+        reader.get(xnode.code_body);
+        return ::std::move(xnode);
+      }
 
-          case xop_itrunc:
-            return do_solidify<AIR_Traits_apply_operator_itrunc>(queue, altr);
+      case index_declare_variable: {
+        S_declare_variable xnode;
+        reader.get(xnode.sloc);
+        reader.get(xnode.name);
+        reader.get(xnode.untracked);
+        return ::std::move(xnode);
+      }
 
-          case xop_cmp_eq:
-            return do_solidify<AIR_Traits_apply_operator_cmp_eq>(queue, altr);
+      case index_initialize_variable: {
+        S_initialize_variable xnode;
+        reader.get(xnode.sloc);
+        reader.get(xnode.immutable);
+        return ::std::move(xnode);
+      }
 
-          case xop_cmp_ne:
-            return do_solidify<AIR_Traits_apply_operator_cmp_ne>(queue, altr);
+      case index_if_statement: {
+        S_if_statement xnode;
+        reader.get(xnode.negative);
+        reader.get(xnode.code_true);
+        reader.get(xnode.code_false);
+        return ::std::move(xnode);
+      }
 
-          case xop_cmp_lt:
-            return do_solidify<AIR_Traits_apply_operator_cmp_lt>(queue, altr);
+      case index_switch_statement: {
+        S_switch_statement xnode;
+        reader.get(xnode.code_labels);
+        reader.get(xnode.code_bodies);
+        reader.get(xnode.names_added);
+        if((xnode.code_bodies.size() != xnode.code_labels.size()) ||
+           (xnode.names_added.size() != xnode.code_labels.size()))
+          reader.throw_invalid();
+        return ::std::move(xnode);
+      }
 
-          case xop_cmp_gt:
-            return do_solidify<AIR_Traits_apply_operator_cmp_gt>(queue, altr);
+      case index_do_while_statement: {
+        S_do_while_statement xnode;
+        reader.get(xnode.code_body);
+        reader.get(xnode.negative);
+        reader.get(xnode.code_cond);
+        return ::std::move(xnode);
+      }
 
-          case xop_cmp_lte:
-            return do_solidify<AIR_Traits_apply_operator_cmp_lte>(queue, altr);
+      case index_while_statement: {
+        S_while_statement xnode;
+        reader.get(xnode.negative);
+        reader.get(xnode.code_cond);
+        reader.get(xnode.code_body);
+        return ::std::move(xnode);
+      }
 
-          case xop_cmp_gte:
-            return do_solidify<AIR_Traits_apply_operator_cmp_gte>(queue, altr);
+      case index_for_each_statement: {
+        S_for_each_statement xnode;
+        reader.get(xnode.name_key);
+        reader.get(xnode.name_mapped);
+        reader.get(xnode.code_init);
+        reader.get(xnode.code_body);
+        return ::std::move(xnode);
+      }
 
-          case xop_cmp_3way:
-            return do_solidify<AIR_Traits_apply_operator_cmp_3way>(queue, altr);
+      case index_for_statement: {
+        S_for_statement xnode;
+        reader.get(xnode.code_init);
+        reader.get(xnode.code_cond);
+        reader.get(xnode.code_step);
+        reader.get(xnode.code_body);
+        return ::std::move(xnode);
+      }
 
-          case xop_add:
-            return do_solidify<AIR_Traits_apply_operator_add>(queue, altr);
+      case index_try_statement: {
+        S_try_statement xnode;
+        reader.get(xnode.sloc_try);
+        reader.get(xnode.code_try);
+        reader.get(xnode.sloc_catch);
+        reader.get(xnode.name_except);
+        reader.get(xnode.code_catch);
+        return ::std::move(xnode);
+      }
 
-          case xop_sub:
-            return do_solidify<AIR_Traits_apply_operator_sub>(queue, altr);
+      case index_throw_statement: {
+        S_throw_statement xnode;
+        reader.get(xnode.sloc);
+        return ::std::move(xnode);
+      }
 
-          case xop_mul:
-            return do_solidify<AIR_Traits_apply_operator_mul>(queue, altr);
+      case index_assert_statement: {
+        S_assert_statement xnode;
+        reader.get(xnode.sloc);
+        reader.get(xnode.negative);
+        reader.get(xnode.msg);
+        return ::std::move(xnode);
+      }
 
-          case xop_div:
-            return do_solidify<AIR_Traits_apply_operator_div>(queue, altr);
+      case index_return_statement: {
+        S_return_statement xnode;
+        reader.get(xnode.status);
+        return ::std::move(xnode);
+      }
 
-          case xop_mod:
-            return do_solidify<AIR_Traits_apply_operator_mod>(queue, altr);
+      case index_glvalue_to_prvalue: {
+        S_glvalue_to_prvalue xnode;
+        reader.get(xnode.sloc);
+        return ::std::move(xnode);
+      }
 
-          case xop_sll:
-            return do_solidify<AIR_Traits_apply_operator_sll>(queue, altr);
+      case index_push_immediate: {
+        S_push_immediate xnode;
+        reader.get(xnode.value);
+        return ::std::move(xnode);
+      }
 
-          case xop_srl:
-            return do_solidify<AIR_Traits_apply_operator_srl>(queue, altr);
+      case index_push_global_reference: {
+        S_push_global_reference xnode;
+        reader.get(xnode.sloc);
+        reader.get(xnode.name);
+        return ::std::move(xnode);
+      }
 
-          case xop_sla:
-            return do_solidify<AIR_Traits_apply_operator_sla>(queue, altr);
+      case index_push_local_reference: {
+        S_push_local_reference xnode;
+        reader.get(xnode.sloc);
+        reader.get(xnode.depth);
+        reader.get(xnode.name);
+        reader.get(xnode.slot);
+        return ::std::move(xnode);
+      }
 
-          case xop_sra:
-            return do_solidify<AIR_Traits_apply_operator_sra>(queue, altr);
+      case index_define_function: {
+        S_define_function xnode;
+        reader.get(xnode.opts);
+        reader.get(xnode.sloc);
+        reader.get(xnode.func);
+        reader.get(xnode.params);
+        reader.get(xnode.code_body);
+        return ::std::move(xnode);
+      }
 
-          case xop_andb:
-            return do_solidify<AIR_Traits_apply_operator_andb>(queue, altr);
+      case index_branch_expression: {
+        S_branch_expression xnode;
+        reader.get(xnode.sloc);
+        reader.get(xnode.code_true);
+        reader.get(xnode.code_false);
+        reader.get(xnode.assign);
+        return ::std::move(xnode);
+      }
 
-          case xop_orb:
-            return do_solidify<AIR_Traits_apply_operator_orb>(queue, altr);
+      case index_coalescence: {
+        S_coalescence xnode;
+        reader.get(xnode.sloc);
+        reader.get(xnode.code_null);
+        reader.get(xnode.assign);
+        return ::std::move(xnode);
+      }
 
-          case xop_xorb:
-            return do_solidify<AIR_Traits_apply_operator_xorb>(queue, altr);
+      case index_function_call: {
+        S_function_call xnode;
+        reader.get(xnode.sloc);
+        reader.get(xnode.nargs);
+        reader.get(xnode.ptc);
+        return ::std::move(xnode);
+      }
 
-          case xop_assign:
-            return do_solidify<AIR_Traits_apply_operator_assign>(queue, altr);
+      case index_member_access: {
+        S_member_access xnode;
+        reader.get(xnode.sloc);
+        reader.get(xnode.name);
+        return ::std::move(xnode);
+      }
 
-          case xop_fma:
-            return do_solidify<AIR_Traits_apply_operator_fma>(queue, altr);
+      case index_push_unnamed_array: {
+        S_push_unnamed_array xnode;
+        reader.get(xnode.sloc);
+        reader.get(xnode.nelems);
+        return ::std::move(xnode);
+      }
 
-          case xop_head:
-            return do_solidify<AIR_Traits_apply_operator_head>(queue, altr);
+      case index_push_unnamed_object: {
+        S_push_unnamed_object xnode;
+        reader.get(xnode.sloc);
+        reader.get(xnode.keys);
+        return ::std::move(xnode);
+      }
 
-          case xop_tail:
-            return do_solidify<AIR_Traits_apply_operator_tail>(queue, altr);
+      case index_apply_operator: {
+        S_apply_operator xnode;
+        reader.get(xnode.sloc);
+        reader.get(xnode.xop);
+        reader.get(xnode.assign);
+        return ::std::move(xnode);
+      }
 
-          default:
-            ASTERIA_TERMINATE("invalid operator type (xop `$1`)", altr.xop);
-        }
+      case index_unpack_struct_array: {
+        S_unpack_struct_array xnode;
+        reader.get(xnode.sloc);
+        reader.get(xnode.immutable);
+        reader.get(xnode.nelems);
+        return ::std::move(xnode);
       }
 
-      case index_unpack_struct_array:
-        return do_solidify<AIR_Traits_unpack_struct_array>(queue,
-                                     this->m_stor.as<index_unpack_struct_array>());
+      case index_unpack_struct_object: {
+        S_unpack_struct_object xnode;
+        reader.get(xnode.sloc);
+        reader.get(xnode.immutable);
+        reader.get(xnode.keys);
+        return ::std::move(xnode);
+      }
 
-      case index_unpack_struct_object:
-        return do_solidify<AIR_Traits_unpack_struct_object>(queue,
-                                     this->m_stor.as<index_unpack_struct_object>());
+      case index_define_null_variable: {
+        S_define_null_variable xnode;
+        reader.get(xnode.immutable);
+        reader.get(xnode.sloc);
+        reader.get(xnode.name);
+        reader.get(xnode.untracked);
+        return ::std::move(xnode);
+      }
 
-      case index_define_null_variable:
-        return do_solidify<AIR_Traits_define_null_variable>(queue,
-                                     this->m_stor.as<index_define_null_variable>());
+      case index_single_step_trap: {
+        S_single_step_trap xnode;
+        reader.get(xnode.sloc);
+        return ::std::move(xnode);
+      }
 
-      case index_single_step_trap:
-        return do_solidify<AIR_Traits_single_step_trap>(queue,
-                                     this->m_stor.as<index_single_step_trap>());
+      case index_variadic_call: {
+        S_variadic_call xnode;
+        reader.get(xnode.sloc);
+        reader.get(xnode.ptc);
+        return ::std::move(xnode);
+      }
 
-      case index_variadic_call:
-        return do_solidify<AIR_Traits_variadic_call>(queue,
-                                     this->m_stor.as<index_variadic_call>());
+      case index_defer_expression: {
+        S_defer_expression xnode;
+        reader.get(xnode.sloc);
+        reader.get(xnode.code_body);
+        return ::std::move(xnode);
+      }
 
-      case index_defer_expression:
-        return do_solidify<AIR_Traits_defer_expression>(queue,
-                                     this->m_stor.as<index_defer_expression>());
+      case index_import_call: {
+        S_import_call xnode;
+        reader.get(xnode.opts);
+        reader.get(xnode.sloc);
+        reader.get(xnode.nargs);
+        return ::std::move(xnode);
+      }
 
-      case index_import_call:
-        return do_solidify<AIR_Traits_import_call>(queue,
-                                     this->m_stor.as<index_import_call>());
+      case index_break_or_continue: {
+        S_break_or_continue xnode;
+        reader.get(xnode.sloc);
+        reader.get(xnode.status);
+        return ::std::move(xnode);
+      }
 
-      case index_break_or_continue:
-        return do_solidify<AIR_Traits_break_or_continue>(queue,
-                                     this->m_stor.as<index_break_or_continue>());
+      case index_declare_reference: {
+        S_declare_reference xnode;
+        reader.get(xnode.name);
+        return ::std::move(xnode);
+      }
 
-      case index_declare_reference:
-        return do_solidify<AIR_Traits_declare_reference>(queue,
-                                     this->m_stor.as<index_declare_reference>());
+      case index_initialize_reference: {
+        S_initialize_reference xnode;
+        reader.get(xnode.sloc);
+        reader.get(xnode.name);
+        return ::std::move(xnode);
+      }
 
-      case index_initialize_reference:
-        return do_solidify<AIR_Traits_initialize_reference>(queue,
-                                     this->m_stor.as<index_initialize_reference>());
+      case index_inline_call: {
+        S_inline_call xnode;
+        reader.get(xnode.sloc);
+        reader.get(xnode.nargs);
+        reader.get(xnode.sloc_func);
+        reader.get(xnode.func);
+        reader.get(xnode.params);
+        reader.get(xnode.code_body);
+        return ::std::move(xnode);
+      }
 
       default:
-        ASTERIA_TERMINATE("invalid AIR node type (index `$1`)", this->index());
+        // This includes `index_push_bound_reference`, which is never serialized.
+        reader.throw_invalid();
     }
   }
 
+bool
+AIR_Node::
+serialize_all(cow_string& data, const cow_vector<AIR_Node>& code)
+  {
+    Writer writer(data);
+    writer.put_varint(air_serial_version);
+    writer.put(code);
+    return writer.okay;
+  }
+
+cow_vector<AIR_Node>
+AIR_Node::
+deserialize_all(const void* data, size_t size)
+  {
+    Reader reader(data, size);
+    if(reader.get_varint() != air_serial_version)
+      reader.throw_invalid();
+
+    cow_vector<AIR_Node> code;
+    reader.get(code);
+    if(reader.bptr != reader.eptr)
+      reader.throw_invalid();
+    return code;
+  }
+
 Variable_Callback&
 AIR_Node::
 enumerate_variables(Variable_Callback& callback)
@@ -4934,6 +7921,12 @@ enumerate_variables(Variable_Callback& callback)
       case index_initialize_reference:
         return callback;
 
+      case index_inline_call: {
+        const auto& altr = this->m_stor.as<index_inline_call>();
+        ::rocket::for_each(altr.code_body, callback);
+        return callback;
+      }
+
       default:
         ASTERIA_TERMINATE("invalid AIR node type (index `$1`)", this->index());
     }
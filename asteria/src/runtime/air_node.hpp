@@ -27,6 +27,7 @@ class AIR_Node
       {
         Source_Location sloc;
         phsh_string name;
+        bool untracked;
       };
 
     struct S_initialize_variable
@@ -126,6 +127,7 @@ class AIR_Node
         Source_Location sloc;
         uint32_t depth;
         phsh_string name;
+        uint32_t slot;
       };
 
     struct S_push_bound_reference
@@ -208,6 +210,7 @@ class AIR_Node
         bool immutable;
         Source_Location sloc;
         phsh_string name;
+        bool untracked;
       };
 
     struct S_single_step_trap
@@ -251,6 +254,16 @@ class AIR_Node
         phsh_string name;
       };
 
+    struct S_inline_call
+      {
+        Source_Location sloc;
+        uint32_t nargs;
+        Source_Location sloc_func;
+        cow_string func;
+        cow_vector<phsh_string> params;
+        cow_vector<AIR_Node> code_body;
+      };
+
     enum Index : uint8_t
       {
         index_clear_stack            =  0,
@@ -290,6 +303,7 @@ class AIR_Node
         index_break_or_continue      = 34,
         index_declare_reference      = 35,
         index_initialize_reference   = 36,
+        index_inline_call            = 37,
       };
 
   private:
@@ -332,10 +346,42 @@ class AIR_Node
         ,S_break_or_continue      // 34,
         ,S_declare_reference      // 35,
         ,S_initialize_reference   // 36,
+        ,S_inline_call            // 37,
       )>;
 
     Storage m_stor;
 
+    struct Fold_Context;
+
+    static
+    bool
+    do_fold_constants(cow_vector<AIR_Node>& code, Fold_Context& fctx);
+
+    struct Escape_Context;
+
+    static
+    void
+    do_find_escapes(const cow_vector<AIR_Node>& code, Escape_Context& ectx);
+
+    void
+    do_collect_references(Escape_Context& ectx)
+      const;
+
+    static
+    void
+    do_mark_untracked(cow_vector<AIR_Node>& code, const Escape_Context& ectx);
+
+    struct Writer;
+    struct Reader;
+
+    void
+    do_serialize(Writer& writer)
+      const;
+
+    static
+    AIR_Node
+    do_deserialize(Reader& reader);
+
   public:
     ASTERIA_VARIANT_CONSTRUCTOR(AIR_Node, Storage, XNodeT, xnode)
       : m_stor(::std::forward<XNodeT>(xnode))
@@ -373,6 +419,53 @@ class AIR_Node
     solidify(AVMC_Queue& queue)
       const;
 
+    // Compress this IR node together with `next`, if they form a known sequence.
+    // If a superinstruction is appended, the return value is the same as
+    // `solidify()`. Otherwise, nothing is appended and a null value is returned.
+    opt<bool>
+    solidify_fused_opt(AVMC_Queue& queue, const AIR_Node& next)
+      const;
+
+    // Compress a sequence of IR nodes, fusing frequent sequences of nodes into
+    // superinstructions. Nodes after the first one that terminates control flow
+    // are not appended. The return value indicates whether the end is reachable.
+    static
+    bool
+    solidify_all(AVMC_Queue& queue, const cow_vector<AIR_Node>& code);
+
+    // Perform constant folding on a sequence of IR nodes, recursively. Operators
+    // whose operands are constants are evaluated, values of immutable variables
+    // that have constant initializers are propagated, branches whose conditions
+    // are constants are eliminated, and equal string constants share storage.
+    // At optimization level 3, calls to small functions are also inlined.
+    // The return value indicates whether `code` has been modified.
+    static
+    bool
+    fold_constants(cow_vector<AIR_Node>& code, const Compiler_Options& opts);
+
+    // Find variables in a function body that never escape, which are those that are
+    // never captured by closures, bound to references, passed to functions or
+    // returned by reference. As they can't be a part of any reference cycle, they
+    // are marked so they will not be tracked by the garbage collector. Bodies of
+    // nested functions are not processed, as they have been processed on their own.
+    static
+    void
+    mark_untracked_variables(cow_vector<AIR_Node>& code);
+
+    // Serialize a sequence of IR nodes, recursively, so they can be stored and loaded
+    // by `deserialize_all()` later, possibly by another process. Nodes that refer to
+    // runtime objects can't be serialized, in which case `false` is returned and the
+    // contents of `data` are unspecified.
+    static
+    bool
+    serialize_all(cow_string& data, const cow_vector<AIR_Node>& code);
+
+    // Load a sequence of IR nodes that have been serialized by `serialize_all()` of
+    // the same version. An exception is thrown if the data are malformed.
+    static
+    cow_vector<AIR_Node>
+    deserialize_all(const void* data, size_t size);
+
     // This is needed because the body of a closure should not be solidified.
     Variable_Callback&
     enumerate_variables(Variable_Callback& callback)
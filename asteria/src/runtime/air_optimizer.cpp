@@ -41,7 +41,11 @@ reload(Abstract_Context* ctx_opt, const cow_vector<phsh_string>& params,
     if(this->m_opts.optimization_level < 2)
       return *this;
 
-    // TODO: Insert optimization passes
+    // Perform constant folding.
+    AIR_Node::fold_constants(this->m_code, this->m_opts);
+
+    // Find variables that don't have to be tracked by the garbage collector.
+    AIR_Node::mark_untracked_variables(this->m_code);
     return *this;
   }
 
@@ -77,20 +81,8 @@ cow_function
 AIR_Optimizer::
 create_function(const Source_Location& sloc, const cow_string& name)
   {
-    // Compose the function signature.
-    // We only do this if `name` really looks like a function name.
-    cow_string func = name;
-    if(is_cctype(name.front(), cctype_namei) && (name.back() != ')')) {
-      func << '(';
-      if(this->m_params.size()) {
-        func << this->m_params[0];
-        for(size_t k = 1;  k != this->m_params.size();  ++k)
-          func << ", " << this->m_params[k];
-      }
-      func << ')';
-    }
-
     // Instantiate the function.
+    auto func = format_function_signature(name, this->m_params);
     return ::rocket::make_refcnt<Instantiated_Function>(this->m_params,
                ::rocket::make_refcnt<Variadic_Arguer>(sloc, ::std::move(func)),
                this->m_code);
@@ -10,7 +10,7 @@ namespace asteria {
 Analytic_Context::
 Analytic_Context(M_function, Abstract_Context* parent_opt,
                  const cow_vector<phsh_string>& params)
-  : m_parent_opt(parent_opt)
+  : m_parent_opt(parent_opt), m_function(true)
   {
     // Set parameters, which are local references.
     bool variadic = false;
@@ -28,12 +28,9 @@ Analytic_Context(M_function, Abstract_Context* parent_opt,
       this->open_named_reference(name) /*= Reference::S_uninit()*/;
     }
 
-    // Set pre-defined references.
-    // N.B. If you have ever changed these, remember to update 'executive_context.cpp'
-    // as well.
-    this->open_named_reference(sref("__varg")) /*= Reference::S_uninit()*/;
-    this->open_named_reference(sref("__this")) /*= Reference::S_uninit()*/;
-    this->open_named_reference(sref("__func")) /*= Reference::S_uninit()*/;
+    // Pre-defined references are created on demand, the same way as in executive
+    // contexts, so names that are declared by the user are likely to be assigned
+    // the same slots.
   }
 
 Analytic_Context::
@@ -41,4 +38,21 @@ Analytic_Context::
   {
   }
 
+Reference*
+Analytic_Context::
+do_lazy_lookup_opt(const phsh_string& name)
+  {
+    // Pre-defined references exist only in function contexts.
+    if(!this->m_function)
+      return nullptr;
+
+    // Create pre-defined references as needed.
+    // N.B. If you have ever changed these, remember to update 'executive_context.cpp'
+    // as well.
+    if(::rocket::is_any_of(name, { sref("__func"), sref("__this"), sref("__varg") }))
+      return &(this->open_named_reference(name) /*= Reference::S_uninit()*/);
+
+    return nullptr;
+  }
+
 }  // namespace asteria
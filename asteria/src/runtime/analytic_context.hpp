@@ -14,6 +14,7 @@ class Analytic_Context
   {
   private:
     Abstract_Context* m_parent_opt;
+    bool m_function = false;
 
   public:
     // A plain context must have a parent context.
@@ -42,9 +43,8 @@ class Analytic_Context
       { return this->get_parent_opt();  }
 
     Reference*
-    do_lazy_lookup_opt(const phsh_string& /*name*/)
-      override
-      { return nullptr;  }
+    do_lazy_lookup_opt(const phsh_string& name)
+      override;
 
   public:
     ASTERIA_NONCOPYABLE_DESTRUCTOR(Analytic_Context);
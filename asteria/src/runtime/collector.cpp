@@ -5,7 +5,12 @@
 #include "collector.hpp"
 #include "variable.hpp"
 #include "variable_callback.hpp"
+#include "../llds/variable_hashset.hpp"
 #include "../utils.hpp"
+#include "../../rocket/mutex.hpp"
+#include "../../rocket/condition_variable.hpp"
+#include <pthread.h>
+#include <time.h>  // ::clock_gettime()
 
 namespace asteria {
 namespace {
@@ -63,6 +68,15 @@ do_traverse(const ContT& cont, FuncT&& func)
     cont.enumerate_variables(walker);
   }
 
+template<typename FuncT>
+void
+do_traverse(const cow_vector<rcptr<Variable>>& vars, FuncT&& func)
+  {
+    Variable_Walker<FuncT> walker(func);
+    for(const auto& var : vars)
+      walker.process(var);
+  }
+
 template<typename FuncT>
 void
 do_traverse(const Variable& var, FuncT&& func)
@@ -74,6 +88,164 @@ do_traverse(const Variable& var, FuncT&& func)
     var.enumerate_variables_descent(walker);
   }
 
+template<typename FuncT>
+void
+do_for_each_in_part(const cow_vector<rcptr<Variable>>& vars, uint32_t k, uint32_t n, FuncT&& func)
+  {
+    // Divide variables into `n` parts evenly, and process the `k`-th one.
+    size_t bpos = vars.size() * k / n;
+    size_t epos = vars.size() * (k + 1) / n;
+    for(size_t i = bpos;  i != epos;  ++i)
+      func(vars[i]);
+  }
+
+inline
+bool
+do_stage(cow_vector<rcptr<Variable>>& staging, const rcptr<Variable>& var)
+  {
+    // If this variable has been staged, fail.
+    if(var->is_gc_staged())
+      return false;
+
+    var->set_gc_staged(true);
+    staging.emplace_back(var);
+    return true;
+  }
+
+inline
+void
+do_clear_staging(cow_vector<rcptr<Variable>>& staging)
+  noexcept
+  {
+    for(const auto& var : staging)
+      var->set_gc_staged(false);
+    staging.clear();
+  }
+
+// Worker threads are shared by all collectors in this process. They are created
+// when needed and never exit.
+class Worker_Pool
+  {
+  public:
+    using Func = void (void* param, uint32_t k);
+
+  private:
+    ::rocket::mutex m_mutex;
+    ::rocket::condition_variable m_avail;
+    ::rocket::condition_variable m_done;
+    uint32_t m_nthreads = 0;
+
+    // These describe the job in progress, if any.
+    bool m_busy = false;
+    Func* m_func = nullptr;
+    void* m_param = nullptr;
+    uint32_t m_nparts = 0;
+    uint32_t m_next = 0;  // the next part to claim
+    uint32_t m_nleft = 0;  // parts that have not finished
+
+  private:
+    static
+    void*
+    do_thread_procedure(void* param)
+      {
+        auto& pool = *static_cast<Worker_Pool*>(param);
+        ::rocket::mutex::unique_lock lock(pool.m_mutex);
+        for(;;) {
+          pool.m_avail.wait(lock, [&] { return pool.m_next < pool.m_nparts;  });
+          pool.do_run_one(lock);
+        }
+      }
+
+    // Claim a part and run it. The mutex is unlocked in the meantime.
+    void
+    do_run_one(::rocket::mutex::unique_lock& lock)
+      {
+        uint32_t k = this->m_next++;
+        auto func = this->m_func;
+        auto param = this->m_param;
+
+        lock.unlock();
+        func(param, k);
+        lock.lock(this->m_mutex);
+
+        if(--(this->m_nleft) == 0)
+          this->m_done.notify_all();
+      }
+
+  public:
+    // Call `func(param, k)` for each `k` in [0,nparts), and wait for all of them
+    // to finish. This thread takes part as well. If the pool is being used by
+    // another collector, or threads can't be created, parts are run by fewer
+    // threads instead.
+    void
+    run(uint32_t nparts, Func* func, void* param)
+      {
+        ::rocket::mutex::unique_lock lock(this->m_mutex);
+        if(this->m_busy) {
+          lock.unlock();
+          for(uint32_t k = 0;  k < nparts;  ++k)
+            func(param, k);
+          return;
+        }
+
+        while(this->m_nthreads + 1 < nparts) {
+          ::pthread_t thrd;
+          if(::pthread_create(&thrd, nullptr, do_thread_procedure, this) != 0)
+            break;
+
+          ::pthread_detach(thrd);
+          this->m_nthreads += 1;
+        }
+
+        this->m_busy = true;
+        this->m_func = func;
+        this->m_param = param;
+        this->m_nparts = nparts;
+        this->m_next = 0;
+        this->m_nleft = nparts;
+        this->m_avail.notify_all();
+
+        while(this->m_next < this->m_nparts)
+          this->do_run_one(lock);
+        this->m_done.wait(lock, [&] { return this->m_nleft == 0;  });
+
+        this->m_busy = false;
+        this->m_func = nullptr;
+        this->m_param = nullptr;
+        this->m_nparts = 0;
+        this->m_next = 0;
+      }
+  };
+
+Worker_Pool&
+do_get_worker_pool()
+  {
+    // The pool is never destroyed, as its threads may be waiting on it while
+    // the process exits.
+    static auto s_pool = new Worker_Pool;
+    return *s_pool;
+  }
+
+template<typename FuncT>
+void
+do_run_parallel(uint32_t nworkers, FuncT&& func)
+  {
+    using Target = typename ::std::remove_reference<FuncT>::type;
+    do_get_worker_pool().run(nworkers,
+        [](void* param, uint32_t k) { (*static_cast<Target*>(param))(k);  },
+        ::std::addressof(func));
+  }
+
+inline
+uint64_t
+do_read_clock_ns()
+  noexcept
+  {
+    ::timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + static_cast<uint64_t>(ts.tv_nsec);
+  }
+
 class Variable_Wiper
   final
   : public Variable_Callback
@@ -93,11 +265,47 @@ class Variable_Wiper
       }
   };
 
+class Variable_Releaser
+  final
+  : public Variable_Callback
+  {
+  protected:
+    bool
+    do_process_one(const rcptr<Variable>& var)
+      override
+      {
+        // Don't modify variables in place which might have side effects.
+        // Children are not enumerated, so this does not recurse.
+        auto value = ::std::move(var->open_value());
+        var->uninitialize();
+        return false;
+      }
+  };
+
 }  // namespace
 
 Collector::
 ~Collector()
   {
+    this->do_abandon_pass();
+    this->do_release_lazy();
+  }
+
+Collector&
+Collector::
+set_threshold_bounds(uint32_t thres_min, uint32_t thres_max)
+  noexcept
+  {
+    if(thres_min >= thres_max) {
+      this->m_thres_min = 0;
+      this->m_thres_max = 0;
+      return *this;
+    }
+
+    this->m_thres_min = thres_min;
+    this->m_thres_max = thres_max;
+    this->m_threshold = ::rocket::clamp(this->m_threshold, thres_min, thres_max);
+    return *this;
   }
 
 bool
@@ -111,93 +319,172 @@ track_variable(const rcptr<Variable>& var)
     return this->m_tracked.insert(var);
   }
 
+bool
+Collector::
+track_variable_lazily(const rcptr<Variable>& var)
+  {
+    this->m_counter++;
+    if(ROCKET_UNEXPECT(this->m_counter > this->m_threshold))
+      this->auto_collect();
+
+    if(!this->m_lazy.insert(var))
+      return false;
+
+    var->set_gc_lazy(this);
+    return true;
+  }
+
+bool
+Collector::
+activate_lazy_variable(const rcptr<Variable>& var)
+  noexcept
+  {
+    if(!this->m_lazy.erase(var))
+      return false;
+
+    var->set_gc_lazy(nullptr);
+    this->m_tracked.insert(var);
+    return true;
+  }
+
 bool
 Collector::
 untrack_variable(const rcptr<Variable>& var)
   noexcept
   {
-    return this->m_tracked.erase(var);
+    if(this->m_tracked.erase(var))
+      return true;
+
+    if(!this->m_lazy.erase(var))
+      return false;
+
+    var->set_gc_lazy(nullptr);
+    return true;
   }
 
-Collector*
+void
 Collector::
-collect_single_opt()
+do_release_lazy()
+  noexcept
   {
-    // Ignore recursive requests.
-    const Sentry sentry(this->m_recur);
-    if(!sentry)
-      return nullptr;
+    // Variables that outlive this collector shall not refer to it.
+    this->m_lazy.start_pass();
+    while(auto qvar = this->m_lazy.visit_next_opt())
+      (*qvar)->set_gc_lazy(nullptr);
+    this->m_lazy.clear();
+  }
 
-    // The algorithm here is described at
-    //   https://pythoninternal.wordpress.com/2014/08/04/the-garbage-collector/
+bool
+Collector::
+do_check_lazy(Collector*& next)
+  {
+    // Lazy variables are not staged, so they are checked one by one. Those that
+    // are referenced by this list only are garbage, as scalar values can't form
+    // cycles. Those that hold values that are not scalar, which have been stored
+    // through `Variable::open_value()`, are tracked as usual, so they are staged
+    // by this collection. The others survive, and are transferred to the next
+    // generation like tracked variables.
+    auto qvar = this->m_lazy.visit_next_opt();
+    if(!qvar)
+      return false;
+
+    // Copy the pointer, as the list is modified below.
+    auto var = *qvar;
+    if(var->use_count() <= 2) {
+      var->uninitialize();
+      var->set_gc_lazy(nullptr);
+      this->m_lazy.erase(var);
+      this->m_stats.collected++;
+
+      // Cache this variable for reallocation.
+      if(this->m_output_opt)
+        this->m_output_opt->insert(var);
+      return true;
+    }
+
+    if(!var->get_value().is_scalar()) {
+      this->activate_lazy_variable(var);
+      return true;
+    }
 
-    // We initialize `gc_ref` to zero then increment it, rather than initialize
-    // `gc_ref` to the reference count then decrement it. This saves us a phase
-    // below.
-    Collector* next = nullptr;
-    auto output = this->m_output_opt;
     auto tied = this->m_tied_opt;
-    this->m_staging.clear();
+    if(!tied)
+      return true;
 
-    // Add variables that are either tracked or reachable indirectly into the
-    // staging area.
-    do_traverse(this->m_tracked,
-      [&](const rcptr<Variable>& root) {
-        // Add a variable that is reachable directly.
-        // The reference from `m_tracked` should be excluded, so we initialize
-        // the `gc_ref` counter to 1.
-        root->reset_gc_ref(1);
+    this->m_lazy.erase(var);
+    tied->m_lazy.insert(var);
+    var->set_gc_lazy(tied);
+    this->m_stats.promoted++;
 
-        // If this variable has been inserted indirectly, finish.
-        if(!this->m_staging.insert(root))
-          return false;
+    // Check whether the next generation needs to be checked as well.
+    if(tied->m_counter++ >= tied->m_threshold)
+      next = tied;
+    return true;
+  }
 
-        // If `root` is the last reference to this variable, it can be marked
-        // for collection immediately.
-        if(root->use_count() <= 2) {
-          root->uninitialize();
-          return false;
-        }
+void
+Collector::
+do_adapt_threshold(size_t nstaged, size_t ncollected)
+  noexcept
+  {
+    if(!this->is_threshold_adaptive() || (nstaged == 0))
+      return;
 
-        // Enumerate variables that are reachable from `root` indirectly.
-        do_traverse(*root,
-          [&](const rcptr<Variable>& child) {
-            // If this variable has been inserted indirectly, finish.
-            if(!this->m_staging.insert(child))
-              return false;
+    // Collections that find little garbage are wasted, and collections that scan
+    // much more variables than those that have triggered them are expensive, so
+    // they should happen less often. Collections that find much garbage should
+    // happen more often, so garbage doesn't accumulate.
+    uint64_t thres = this->m_threshold;
+    if(ncollected * 2 > nstaged)
+      thres -= thres / 4;
+    else if((ncollected * 4 < nstaged) || (nstaged / 8 > thres))
+      thres = thres * 2 + 1;
 
-            // Initialize the `gc_ref` counter.
-            // N.B. If this variable is encountered later from `m_tracked`,
-            // the `gc_ref` counter will be overwritten with 1.
-            child->reset_gc_ref(0);
-            return true;
-          });
-        return false;
-      });
+    thres = ::rocket::clamp(thres, this->m_thres_min, this->m_thres_max);
+    this->m_threshold = static_cast<uint32_t>(thres);
+  }
+
+void
+Collector::
+do_erase_zombie(const rcptr<Variable>& var)
+  {
+    // Zombie variables can now be erased safely. Those that are tracked by other
+    // collectors are left to them.
+    var->uninitialize();
+    if(!this->m_tracked.erase(var))
+      return;
 
+    // Cache this variable for reallocation.
+    if(this->m_output_opt)
+      this->m_output_opt->insert(var);
+  }
+
+void
+Collector::
+do_count_and_mark_sequential()
+  {
     // Drop references directly or indirectly from `m_staging`.
+    // Each variable in `m_staging` is enumerated exactly once here, so references
+    // from it are dropped exactly once, no matter whether it has been encountered
+    // as a child before.
     do_traverse(this->m_staging,
       [&](const rcptr<Variable>& root) {
         // Drop a direct reference.
-        bool marked = root->add_gc_ref();
+        root->add_gc_ref();
         ROCKET_ASSERT(root->get_gc_ref() <= root->use_count());
-        if(marked)
-          return false;
 
         if(!root->is_initialized()) {
-          // Zombie variables can now be erased safely.
-          root->uninitialize();
-          this->m_tracked.erase(root);
-
-          // Cache this variable for reallocation.
-          if(output)
-            output->insert(root);
+          this->do_erase_zombie(root);
           return false;
         }
 
         // Enumerate variables that are reachable from `root` indirectly.
         do_traverse(*root,
           [&](const rcptr<Variable>& child) {
+            // Variables that have not been staged are not counted.
+            if(!child->is_gc_staged())
+              return false;
+
             // Drop an indirect reference.
             child->add_gc_ref();
             ROCKET_ASSERT(child->get_gc_ref() <= child->use_count());
@@ -219,8 +506,9 @@ collect_single_opt()
         // Mark all children reachable as well.
         do_traverse(*root,
           [&](const rcptr<Variable>& child) {
-            // Skip variables that have already been marked.
-            if(child->get_gc_ref() < 0)
+            // Skip variables that have not been staged or have already been
+            // marked.
+            if(!child->is_gc_staged() || (child->get_gc_ref() < 0))
               return false;
 
             // Mark it and its children recursively.
@@ -229,12 +517,119 @@ collect_single_opt()
           });
         return false;
       });
+  }
+
+void
+Collector::
+do_count_and_mark_parallel(uint32_t nworkers)
+  {
+    // This is the same as above, but variables in `m_staging` are divided into
+    // parts, each of which is processed by a thread. Zombie variables have to be
+    // erased by this thread beforehand.
+    do_traverse(this->m_staging,
+      [&](const rcptr<Variable>& root) {
+        if(!root->is_initialized())
+          this->do_erase_zombie(root);
+        return false;
+      });
+
+    // Drop references directly or indirectly from `m_staging`. Counters of
+    // children may be updated by other threads.
+    do_run_parallel(nworkers,
+      [&](uint32_t k) {
+        do_for_each_in_part(this->m_staging, k, nworkers,
+          [&](const rcptr<Variable>& root) {
+            root->add_gc_ref_concurrent();
+            if(!root->is_initialized())
+              return;
+
+            do_traverse(*root,
+              [&](const rcptr<Variable>& child) {
+                if(child->is_gc_staged())
+                  child->add_gc_ref_concurrent();
+                return false;
+              });
+          });
+      });
+
+    // Find variables that are reachable directly, and mark them with -2. Each
+    // thread only accesses variables in its own part.
+    do_run_parallel(nworkers,
+      [&](uint32_t k) {
+        do_for_each_in_part(this->m_staging, k, nworkers,
+          [&](const rcptr<Variable>& root) {
+            ROCKET_ASSERT(root->get_gc_ref() <= root->use_count());
+            if(root->get_gc_ref() < root->use_count())
+              root->reset_gc_ref(-2);
+          });
+      });
+
+    // Mark variables reachable with -1. A variable is claimed by the thread that
+    // marks it, which then marks its children, so each one is processed once.
+    do_run_parallel(nworkers,
+      [&](uint32_t k) {
+        do_for_each_in_part(this->m_staging, k, nworkers,
+          [&](const rcptr<Variable>& root) {
+            if(root->load_gc_ref_concurrent() != -2)
+              return;
+
+            if(root->exchange_gc_ref_concurrent(-1) == -1)
+              return;
+
+            do_traverse(*root,
+              [&](const rcptr<Variable>& child) {
+                return child->is_gc_staged() &&
+                       (child->exchange_gc_ref_concurrent(-1) != -1);
+              });
+          });
+      });
+  }
+
+Collector*
+Collector::
+do_promote(const rcptr<Variable>& var)
+  {
+    // Transfer this variable to the next generational collector, if one has been
+    // tied. Variables that are tracked by other collectors are left intact.
+    auto tied = this->m_tied_opt;
+    if(!tied || !this->m_tracked.erase(var))
+      return nullptr;
+
+    tied->m_tracked.insert(var);
+    this->m_stats.promoted++;
+
+    // Check whether the next generation needs to be checked as well.
+    if(tied->m_counter++ < tied->m_threshold)
+      return nullptr;
+    return tied;
+  }
+
+Collector*
+Collector::
+do_collect_staging(uint64_t since)
+  {
+    Collector* next = nullptr;
+    auto output = this->m_output_opt;
+    auto tied = this->m_tied_opt;
+
+    // Use multiple threads if there are enough variables.
+    uint32_t nworkers = this->m_nworkers;
+    if(nworkers > 1)
+      nworkers = static_cast<uint32_t>(::rocket::min(size_t(nworkers),
+                                          this->m_staging.size() / parallel_min_per_worker));
+    if(nworkers > 1)
+      this->do_count_and_mark_parallel(nworkers);
+    else
+      this->do_count_and_mark_sequential();
 
     // Collect unreachable variables.
+    size_t ncollected = 0;
     do_traverse(this->m_staging,
       [&](const rcptr<Variable>& root) {
         // All variables that are reachable shall have negative `gc_ref` values.
         if(root->get_gc_ref() >= 0) {
+          ncollected++;
+
           // Break reference cycles.
           root->uninitialize();
           this->m_tracked.erase(root);
@@ -245,23 +640,360 @@ collect_single_opt()
           return false;
         }
 
-        if(tied) {
-          // Transfer this variable to the next generational collector, if one
-          // has been tied.
-          tied->m_tracked.insert(root);
-          this->m_tracked.erase(root);
+        if(auto qnext = this->do_promote(root))
+          next = qnext;
+        return false;
+      });
+
+    // If the next generation is in the middle of an incremental pass, it shall
+    // proceed by a slice.
+    if(tied && tied->is_pass_in_progress())
+      next = tied;
+
+    this->do_adapt_threshold(this->m_staging.size(), ncollected);
+
+    // Update statistics.
+    uint64_t pause = do_read_clock_ns() - since;
+    this->m_stats.collections++;
+    this->m_stats.pause_total += pause;
+    this->m_stats.pause_max = ::rocket::max(this->m_stats.pause_max, pause);
+    this->m_stats.scanned += this->m_staging.size();
+    this->m_stats.collected += ncollected;
+
+    do_clear_staging(this->m_staging);
+    this->m_counter = 0;
+    return next;
+  }
+
+void
+Collector::
+do_abandon_pass()
+  noexcept
+  {
+    do_clear_staging(this->m_staging);
+    do_clear_staging(this->m_garbage);
+    this->m_marking.clear();
+    this->m_in_pass = false;
+  }
+
+bool
+Collector::
+do_step_pass(Collector*& next)
+  {
+    switch(this->m_phase) {
+      case phase_lazy:
+        // Check a lazy variable.
+        if(this->do_check_lazy(next))
+          return true;
+
+        this->m_phase = phase_stage;
+        this->m_cursor = 0;
+        return true;
+
+      case phase_stage: {
+        // Only variables that are tracked by this collector are staged, so the
+        // state of a pass is never shared with other collectors. Variables that
+        // are not tracked, which can't be a part of a cycle, are not staged, and
+        // variables that they reference are considered reachable.
+        // When a variable is staged, its `gc_ref` counter is initialized to 2,
+        // which excludes the references from `m_tracked` and `m_staging`.
+        if(this->m_cursor == this->m_staging.size()) {
+          // Stage the next variable that has not been visited in this pass. If
+          // there is none, all variables have been staged.
+          auto qroot = this->m_tracked.visit_next_opt();
+          if(!qroot) {
+            this->m_phase = phase_mark;
+            this->m_cursor = 0;
+            this->m_nstaged = this->m_staging.size();
+            return true;
+          }
+
+          const auto& root = *qroot;
+          if(!do_stage(this->m_staging, root))
+            return true;
+
+          // If `root` is the last reference to this variable, it can be marked
+          // for collection immediately.
+          root->reset_gc_ref(2);
+          if(root->use_count() <= 2)
+            root->uninitialize();
+          return true;
+        }
+
+        // Count references from a staged variable to others. They are staged
+        // now if they haven't been, so each reference is counted exactly once.
+        auto var = this->m_staging[this->m_cursor++];
+        do_traverse(*var,
+          [&](const rcptr<Variable>& child) {
+            if(!this->m_tracked.has(child))
+              return false;
+
+            if(do_stage(this->m_staging, child))
+              child->reset_gc_ref(2);
+            child->add_gc_ref();
+            return false;
+          });
+        return true;
+      }
+
+      case phase_mark: {
+        // Mark children of a variable which is known to be reachable.
+        if(!this->m_marking.empty()) {
+          auto var = ::std::move(this->m_marking.mut_back());
+          this->m_marking.pop_back();
+          do_traverse(*var,
+            [&](const rcptr<Variable>& child) {
+              if(child->is_gc_staged() && this->m_tracked.has(child) && (child->get_gc_ref() >= 0)) {
+                child->reset_gc_ref(-1);
+                this->m_marking.emplace_back(child);
+              }
+              return false;
+            });
+          return true;
+        }
+
+        // Find the next variable that is referenced from somewhere else.
+        if(this->m_cursor == this->m_staging.size()) {
+          this->m_phase = phase_sweep;
+          return true;
+        }
+
+        const auto& var = this->m_staging[this->m_cursor++];
+        if((var->get_gc_ref() >= 0) && (var->get_gc_ref() < var->use_count())) {
+          var->reset_gc_ref(-1);
+          this->m_marking.emplace_back(var);
+        }
+        return true;
+      }
+
+      case phase_sweep: {
+        // Variables that have not been marked are candidates for collection, and
+        // are kept staged. The others survive this pass.
+        if(this->m_staging.empty())
+          return false;
+
+        auto var = ::std::move(this->m_staging.mut_back());
+        this->m_staging.pop_back();
+        if((var->get_gc_ref() >= 0) && this->m_tracked.has(var)) {
+          this->m_garbage.emplace_back(::std::move(var));
+          return true;
+        }
+
+        var->set_gc_staged(false);
+        if(auto qnext = this->do_promote(var))
+          next = qnext;
+        return true;
+      }
+
+      default:
+        ROCKET_ASSERT(false);
+    }
+    return false;
+  }
+
+size_t
+Collector::
+do_collect_garbage(Collector*& next)
+  {
+    // Candidates are checked again, as values may have been modified since they
+    // were counted. This is the same algorithm as a full collection, where only
+    // candidates are staged, so everything that is collected has been verified
+    // at this moment. References from `m_tracked` and `m_garbage` are excluded.
+    do_traverse(this->m_garbage,
+      [&](const rcptr<Variable>& root) {
+        root->reset_gc_ref(this->m_tracked.has(root) ? 2 : -1);
+        return false;
+      });
+
+    do_traverse(this->m_garbage,
+      [&](const rcptr<Variable>& root) {
+        if(root->get_gc_ref() < 0)
+          return false;
+
+        do_traverse(*root,
+          [&](const rcptr<Variable>& child) {
+            if(child->is_gc_staged() && this->m_tracked.has(child) && (child->get_gc_ref() >= 0))
+              child->add_gc_ref();
+            return false;
+          });
+        return false;
+      });
+
+    do_traverse(this->m_garbage,
+      [&](const rcptr<Variable>& root) {
+        if((root->get_gc_ref() < 0) || (root->get_gc_ref() >= root->use_count()))
+          return false;
+
+        root->reset_gc_ref(-1);
+        do_traverse(*root,
+          [&](const rcptr<Variable>& child) {
+            if(!child->is_gc_staged() || !this->m_tracked.has(child) || (child->get_gc_ref() < 0))
+              return false;
+
+            child->reset_gc_ref(-1);
+            return true;
+          });
+        return false;
+      });
+
+    // Collect variables that are still unreachable.
+    size_t ncollected = 0;
+    do_traverse(this->m_garbage,
+      [&](const rcptr<Variable>& root) {
+        if(root->get_gc_ref() < 0) {
+          if(auto qnext = this->do_promote(root))
+            next = qnext;
+          return false;
+        }
+
+        ncollected++;
+
+        // Break reference cycles.
+        root->uninitialize();
+        this->m_tracked.erase(root);
+
+        // Cache this variable for reallocation.
+        if(this->m_output_opt)
+          this->m_output_opt->insert(root);
+        return false;
+      });
+
+    this->m_stats.scanned += this->m_garbage.size();
+    do_clear_staging(this->m_garbage);
+    return ncollected;
+  }
+
+Collector*
+Collector::
+collect_single_opt()
+  {
+    // Ignore recursive requests.
+    const Sentry sentry(this->m_recur);
+    if(!sentry)
+      return nullptr;
+
+    uint64_t since = do_read_clock_ns();
+
+    // The algorithm here is described at
+    //   https://pythoninternal.wordpress.com/2014/08/04/the-garbage-collector/
+
+    // We initialize `gc_ref` to zero then increment it, rather than initialize
+    // `gc_ref` to the reference count then decrement it. This saves us a phase
+    // below.
+
+    // Variables that are tracked by other collectors are neither staged nor
+    // traversed. References from them are not counted, so variables that they
+    // reference are considered reachable, and reference counts serve as the
+    // remembered set. Likewise, they are considered reachable themselves, as the
+    // references from other collectors are not counted. Cycles that span
+    // generations are collected after they have been promoted into the same
+    // generation. Thus the cost of a collection is proportional to the number of
+    // variables that are tracked by this collector, not to the size of the heap.
+    this->do_abandon_pass();
+
+    Collector* next = nullptr;
+    this->m_lazy.start_pass();
+    while(this->do_check_lazy(next));
+
+    this->m_tracked.start_pass();
+
+    // Add variables that are either tracked or reachable indirectly into the
+    // staging area, except those that are tracked by other collectors.
+    do_traverse(this->m_tracked,
+      [&](const rcptr<Variable>& root) {
+        // Add a variable that is reachable directly.
+        // The reference from `m_tracked` should be excluded, so we initialize
+        // the `gc_ref` counter to 1.
+        root->reset_gc_ref(1);
+
+        // If this variable has been inserted indirectly, finish.
+        if(!do_stage(this->m_staging, root))
+          return false;
 
-          // Check whether the next generation needs to be checked as well.
-          if(tied->m_counter++ >= tied->m_threshold)
-            next = tied;
+        // If `root` is the last reference to this variable, it can be marked
+        // for collection immediately.
+        if(root->use_count() <= 2) {
+          root->uninitialize();
           return false;
         }
 
-        // Leave this variable intact.
+        // Enumerate variables that are reachable from `root` indirectly.
+        do_traverse(*root,
+          [&](const rcptr<Variable>& child) {
+            // Variables that are tracked by other collectors are not staged.
+            if(child->is_gc_tracked() && !this->m_tracked.has(child))
+              return false;
+
+            // If this variable has been inserted indirectly, finish.
+            if(!do_stage(this->m_staging, child))
+              return false;
+
+            // Initialize the `gc_ref` counter.
+            // N.B. If this variable is encountered later from `m_tracked`,
+            // the `gc_ref` counter will be overwritten with 1.
+            child->reset_gc_ref(0);
+            return true;
+          });
         return false;
       });
 
-    this->m_staging.clear();
+    auto next_staged = this->do_collect_staging(since);
+    return next_staged ? next_staged : next;
+  }
+
+Collector*
+Collector::
+collect_slice_opt()
+  {
+    if(this->m_slice == 0)
+      return this->collect_single_opt();
+
+    // Ignore recursive requests.
+    const Sentry sentry(this->m_recur);
+    if(!sentry)
+      return nullptr;
+
+    uint64_t since = do_read_clock_ns();
+
+    // This is the same algorithm as above, but it is divided into steps, each of
+    // which processes one variable, and the state of a pass is kept across
+    // slices. A slice stops after `m_slice` steps. Variables that remain unmarked
+    // at the end of a pass are checked again before they are collected.
+    Collector* next = nullptr;
+    if(!this->m_in_pass) {
+      this->m_in_pass = true;
+      this->m_phase = phase_lazy;
+      this->m_lazy.start_pass();
+      this->m_tracked.start_pass();
+    }
+
+    size_t nsteps = 0;
+    while(nsteps < this->m_slice) {
+      nsteps++;
+      if(this->do_step_pass(next))
+        continue;
+
+      // The pass is complete.
+      size_t ncollected = this->do_collect_garbage(next);
+      this->m_stats.collected += ncollected;
+      this->do_adapt_threshold(this->m_nstaged, ncollected);
+      this->m_in_pass = false;
+      break;
+    }
+
+    // If the next generation is in the middle of an incremental pass, it shall
+    // proceed by a slice.
+    auto tied = this->m_tied_opt;
+    if(tied && tied->is_pass_in_progress())
+      next = tied;
+
+    // Update statistics.
+    uint64_t pause = do_read_clock_ns() - since;
+    this->m_stats.collections++;
+    this->m_stats.pause_total += pause;
+    this->m_stats.pause_max = ::rocket::max(this->m_stats.pause_max, pause);
+    this->m_stats.scanned += nsteps;
+
     this->m_counter = 0;
     return next;
   }
@@ -272,7 +1004,7 @@ auto_collect()
   {
     auto qnext = this;
     do
-      qnext = qnext->collect_single_opt();
+      qnext = qnext->collect_slice_opt();
     while(qnext);
   }
 
@@ -289,7 +1021,29 @@ wipe_out_variables()
     // Wipe all variables recursively.
     Variable_Wiper wiper;
     this->m_tracked.enumerate_variables(wiper);
+    this->m_lazy.enumerate_variables(wiper);
     return *this;
   }
 
+bool
+Collector::
+release_variables()
+  noexcept
+  {
+    const Sentry sentry(this->m_recur);
+    if(!sentry)
+      return false;
+
+    this->do_abandon_pass();
+
+    // Drop all values first, so variables are only referenced by this list,
+    // unless they have escaped. Then release them in one go.
+    Variable_Releaser releaser;
+    this->m_tracked.enumerate_variables(releaser);
+    this->m_tracked.clear();
+    this->m_lazy.enumerate_variables(releaser);
+    this->do_release_lazy();
+    return true;
+  }
+
 }  // namespace asteria
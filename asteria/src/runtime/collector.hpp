@@ -5,12 +5,33 @@
 #define ASTERIA_RUNTIME_COLLECTOR_HPP_
 
 #include "../fwd.hpp"
-#include "../llds/variable_hashset.hpp"
+#include "../llds/variable_list.hpp"
 
 namespace asteria {
 
 class Collector
   {
+  public:
+    enum : size_t
+      {
+        // Parallel collection only takes place if there are at least this number
+        // of variables for each thread.
+        parallel_min_per_worker = 8192,
+      };
+
+    // These are statistics of collections, which are only informative. Times
+    // are in nanoseconds.
+    struct Stats
+      {
+        uint64_t collections = 0;
+        uint64_t pause_total = 0;
+        uint64_t pause_max = 0;
+        uint64_t scanned = 0;  // variables staged, or processed by slices
+        uint64_t collected = 0;
+        uint64_t promoted = 0;  // variables transferred to the next generation
+        uint64_t pool_hits = 0;  // variables allocated from the pool
+      };
+
   private:
     Variable_HashSet* m_output_opt;
     Collector* m_tied_opt;
@@ -18,8 +39,36 @@ class Collector
 
     uint32_t m_counter = 0;
     long m_recur = 0;
-    Variable_HashSet m_tracked;
-    Variable_HashSet m_staging;
+    Variable_List m_tracked;
+    Variable_List m_lazy;  // variables that have only held scalar values
+    cow_vector<rcptr<Variable>> m_staging;
+
+    // These are used by incremental collection. Candidates for collection are
+    // moved from `m_staging` to `m_garbage` at the end of a pass.
+    enum Phase : uint8_t
+      {
+        phase_lazy   = 0,  // checking lazy variables
+        phase_stage  = 1,  // staging variables and counting references
+        phase_mark   = 2,  // marking reachable variables
+        phase_sweep  = 3,  // finding candidates and promoting survivors
+      };
+
+    uint32_t m_slice = 0;
+    bool m_in_pass = false;
+    Phase m_phase = phase_lazy;
+    size_t m_cursor = 0;
+    size_t m_nstaged = 0;
+    cow_vector<rcptr<Variable>> m_marking;
+    cow_vector<rcptr<Variable>> m_garbage;
+
+    // This is used by parallel collection.
+    uint32_t m_nworkers = 0;
+
+    // These are used by adaptive thresholds.
+    uint32_t m_thres_min = 0;
+    uint32_t m_thres_max = 0;
+
+    Stats m_stats;
 
   public:
     explicit
@@ -28,6 +77,43 @@ class Collector
       : m_output_opt(output_opt), m_tied_opt(tied_opt), m_threshold(threshold)
       { }
 
+  private:
+    void
+    do_release_lazy()
+      noexcept;
+
+    bool
+    do_check_lazy(Collector*& next);
+
+    void
+    do_erase_zombie(const rcptr<Variable>& var);
+
+    void
+    do_count_and_mark_sequential();
+
+    void
+    do_count_and_mark_parallel(uint32_t nworkers);
+
+    void
+    do_adapt_threshold(size_t nstaged, size_t ncollected)
+      noexcept;
+
+    Collector*
+    do_promote(const rcptr<Variable>& var);
+
+    Collector*
+    do_collect_staging(uint64_t since);
+
+    void
+    do_abandon_pass()
+      noexcept;
+
+    bool
+    do_step_pass(Collector*& next);
+
+    size_t
+    do_collect_garbage(Collector*& next);
+
   public:
     ASTERIA_NONCOPYABLE_DESTRUCTOR(Collector);
 
@@ -56,32 +142,149 @@ class Collector
       const noexcept
       { return this->m_threshold;  }
 
+    // Setting the threshold explicitly disables adaptive thresholds.
     Collector&
     set_threshold(uint32_t threshold)
       noexcept
-      { return this->m_threshold = threshold, *this;  }
+      {
+        this->m_thres_min = 0;
+        this->m_thres_max = 0;
+        this->m_threshold = threshold;
+        return *this;
+      }
+
+    // If adaptive thresholds are enabled, the threshold is adjusted after each
+    // collection within these bounds. It is raised if most variables survive, or
+    // if the staging area is much larger than the threshold, which makes each
+    // collection expensive. It is lowered if most variables are collected.
+    bool
+    is_threshold_adaptive()
+      const noexcept
+      { return this->m_thres_min < this->m_thres_max;  }
 
+    uint32_t
+    get_threshold_min()
+      const noexcept
+      { return this->m_thres_min;  }
+
+    uint32_t
+    get_threshold_max()
+      const noexcept
+      { return this->m_thres_max;  }
+
+    // If `thres_min` is not less than `thres_max`, adaptive thresholds are
+    // disabled. Otherwise the current threshold is clamped into these bounds.
+    Collector&
+    set_threshold_bounds(uint32_t thres_min, uint32_t thres_max)
+      noexcept;
+
+    // If the slice size is zero, each collection processes all variables that are
+    // tracked. Otherwise, collection is incremental: a pass is divided into
+    // slices, each of which processes at most this number of variables, and
+    // resumes where the previous one stopped. As values may be modified between
+    // slices, variables that a pass finds unreachable are checked again by its
+    // last slice before they are collected, so that slice also processes each
+    // variable it collects. Slices are always processed by the calling thread.
+    uint32_t
+    get_slice_size()
+      const noexcept
+      { return this->m_slice;  }
+
+    Collector&
+    set_slice_size(uint32_t slice)
+      noexcept
+      { return this->m_slice = slice, *this;  }
+
+    // Check whether an incremental pass is in progress. While it is, every
+    // collection of the previous generation is followed by a slice of this one.
+    bool
+    is_pass_in_progress()
+      const noexcept
+      { return this->m_in_pass;  }
+
+    // If the number of workers is greater than one, references are counted and
+    // reachable variables are marked by this number of threads, including the
+    // calling thread, if there are enough variables. Results are the same.
+    uint32_t
+    get_worker_count()
+      const noexcept
+      { return this->m_nworkers;  }
+
+    Collector&
+    set_worker_count(uint32_t nworkers)
+      noexcept
+      { return this->m_nworkers = nworkers, *this;  }
+
+    const Stats&
+    get_stats()
+      const noexcept
+      { return this->m_stats;  }
+
+    Stats&
+    open_stats()
+      noexcept
+      { return this->m_stats;  }
+
+    Collector&
+    clear_stats()
+      noexcept
+      { return this->m_stats = Stats(), *this;  }
+
+    // Variables that are tracked lazily are included.
     size_t
     count_tracked_variables()
       const noexcept
-      { return this->m_tracked.size();  }
+      { return this->m_tracked.size() + this->m_lazy.size();  }
+
+    size_t
+    count_lazy_variables()
+      const noexcept
+      { return this->m_lazy.size();  }
 
     bool
     track_variable(const rcptr<Variable>& var);
 
+    // Track a variable which holds a scalar value lazily. Such a variable is not
+    // staged, as scalar values can't form cycles. Before each collection, lazy
+    // variables that are no longer referenced elsewhere are collected, and
+    // those that hold values that are not scalar are tracked as usual.
+    bool
+    track_variable_lazily(const rcptr<Variable>& var);
+
+    // Track a lazy variable as usual, because it is about to hold a value that
+    // is not scalar.
+    bool
+    activate_lazy_variable(const rcptr<Variable>& var)
+      noexcept;
+
     bool
     untrack_variable(const rcptr<Variable>& var)
       noexcept;
 
+    // Perform a full collection. An incremental pass is abandoned.
     Collector*
     collect_single_opt();
 
+    // Perform a slice of collection if collection is incremental, and a full
+    // one otherwise.
+    Collector*
+    collect_slice_opt();
+
     void
     auto_collect();
 
     Collector&
     wipe_out_variables()
       noexcept;
+
+    // Uninitialize all tracked variables without descending into their values,
+    // then release them. Every cycle that passes through a tracked variable is
+    // broken this way. Variables that are referenced elsewhere are left
+    // uninitialized and are no longer tracked. If a collection is in progress,
+    // nothing is done, and `false` is returned.
+    bool
+    release_variables()
+      noexcept;
   };
 
 }  // namespace asteria
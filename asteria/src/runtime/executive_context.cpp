@@ -20,12 +20,6 @@ Executive_Context(M_function, Global_Context& global, Reference_Stack& stack,
     m_global(&global), m_stack(&stack), m_alt_stack(&alt_stack),
     m_zvarg(zvarg)
   {
-    // Set the `this` reference.
-    // If the self reference is void, it is likely that `this` isn't ever referenced in
-    // this function, so perform lazy initialization to avoid this overhead.
-    if(!self.is_void() && !(self.is_constant() && self.dereference_readonly().is_null()))
-      this->open_named_reference(sref("__this")) = ::std::move(self);
-
     // Prepare iterators to arguments.
     // As function arguments are evaluated from left to right, the reference at the top
     // is the last argument.
@@ -56,6 +50,14 @@ Executive_Context(M_function, Global_Context& global, Reference_Stack& stack,
     if(!variadic && (bpos != epos))
       ASTERIA_THROW("Too many arguments passed to `$1`", zvarg->func());
 
+    // Set the `this` reference.
+    // If the self reference is void, it is likely that `this` isn't ever referenced in
+    // this function, so perform lazy initialization to avoid this overhead.
+    // This is done after parameters, so they are assigned the same slots as in the
+    // analytic context.
+    if(!self.is_void() && !(self.is_constant() && self.dereference_readonly().is_null()))
+      this->open_named_reference(sref("__this")) = ::std::move(self);
+
     // Stash variadic arguments, if any.
     this->m_lazy_args.append(::std::make_move_iterator(bpos),
                              ::std::make_move_iterator(epos));
@@ -84,6 +84,12 @@ class Executive_Context
       const noexcept
       { return this->m_parent_opt;  }
 
+    // This is null if this is not a function context.
+    const Variadic_Arguer*
+    get_zvarg_opt()
+      const noexcept
+      { return this->m_zvarg.get();  }
+
     Global_Context&
     global()
       const noexcept
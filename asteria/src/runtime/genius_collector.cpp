@@ -45,7 +45,23 @@ create_variable(GC_Generation gc_hint)
     auto var = this->m_pool.erase_random_opt();
     if(ROCKET_UNEXPECT(!var))
       var = ::rocket::make_refcnt<Variable>();
-    coll.track_variable(var);
+    else
+      coll.open_stats().pool_hits++;
+
+    // Mark it uninitialized. It holds a scalar value, so it is tracked lazily.
+    var->uninitialize();
+    coll.track_variable_lazily(var);
+    return var;
+  }
+
+rcptr<Variable>
+Genius_Collector::
+create_untracked_variable()
+  {
+    // Try allocating a variable from the pool.
+    auto var = this->m_pool.erase_random_opt();
+    if(ROCKET_UNEXPECT(!var))
+      var = ::rocket::make_refcnt<Variable>();
 
     // Mark it uninitialized.
     var->uninitialize();
@@ -79,4 +95,18 @@ wipe_out_variables()
     return *this;
   }
 
+bool
+Genius_Collector::
+release_variables()
+  noexcept
+  {
+    // Variables in the pool are uninitialized, so they can't form cycles.
+    this->m_pool.clear();
+
+    // Release variables from the newest generation to the oldest.
+    return this->m_newest.release_variables() &&
+           this->m_middle.release_variables() &&
+           this->m_oldest.release_variables();
+  }
+
 }  // namespace asteria
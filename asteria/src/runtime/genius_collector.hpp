@@ -28,7 +28,11 @@ class Genius_Collector
       : m_oldest(&(this->m_pool), nullptr, 10),
         m_middle(&(this->m_pool), &(this->m_oldest), 60),
         m_newest(&(this->m_pool), &(this->m_middle), 800)
-      { }
+      {
+        this->m_oldest.set_threshold_bounds(3, 160);
+        this->m_middle.set_threshold_bounds(15, 960);
+        this->m_newest.set_threshold_bounds(200, 12800);
+      }
 
   private:
     Collector Genius_Collector::*
@@ -57,15 +61,30 @@ class Genius_Collector
     open_collector(GC_Generation gc_gen)
       { return this->*(this->do_locate(gc_gen));  }
 
+    // Allocate a variable which is tracked by the collector for `gc_hint`. It is
+    // tracked lazily until it holds a value that is not scalar.
     rcptr<Variable>
     create_variable(GC_Generation gc_hint = gc_generation_newest);
 
+    // Allocate a variable which is not tracked by any collector. This is only safe
+    // if the variable can never be a part of a reference cycle.
+    rcptr<Variable>
+    create_untracked_variable();
+
     size_t
     collect_variables(GC_Generation gc_limit = gc_generation_oldest);
 
     Genius_Collector&
     wipe_out_variables()
       noexcept;
+
+    // Release all variables in bulk, which is much cheaper than wiping them out
+    // recursively. This is intended for destruction of global contexts. If a
+    // collection is in progress, `false` is returned, and some variables may
+    // remain tracked.
+    bool
+    release_variables()
+      noexcept;
   };
 
 }  // namespace asteria
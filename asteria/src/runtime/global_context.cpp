@@ -8,6 +8,7 @@
 #include "loader_lock.hpp"
 #include "variable.hpp"
 #include "abstract_hooks.hpp"
+#include "global_snapshot.hpp"
 #include "../library/version.hpp"
 #include "../library/system.hpp"
 #include "../library/debug.hpp"
@@ -21,6 +22,7 @@
 #include "../library/json.hpp"
 #include "../library/io.hpp"
 #include "../utils.hpp"
+#include "../../rocket/mutex.hpp"
 
 namespace asteria {
 namespace {
@@ -69,6 +71,29 @@ struct Module_Comparator
       { return lhs.version < rhs;  }
   };
 
+// The standard library is immutable, so it is created only once for each API
+// version, and is shared by all global contexts. The element at index `k` has
+// `k + 1` modules. Empty elements have not been created yet.
+::rocket::mutex s_std_mutex;
+cow_dictionary<Value> s_std_cache[::std::extent<decltype(s_modules)>::value];
+
+cow_dictionary<Value>
+do_create_std(const Module* bptr, const Module* eptr)
+  {
+    // Initialize library modules.
+    cow_dictionary<Value> ostd;
+    for(auto q = bptr;  q != eptr;  ++q) {
+      // Create the subobject if it doesn't exist.
+      auto pair = ostd.try_emplace(sref(q->name));
+      if(pair.second) {
+        ROCKET_ASSERT(pair.first->second.is_null());
+        pair.first->second = cow_dictionary<Value>();
+      }
+      q->init(pair.first->second.open_object(), eptr[-1].version);
+    }
+    return ostd;
+  }
+
 }  // namespace
 
 Global_Context::
@@ -83,23 +108,23 @@ Global_Context(API_Version version)
     // Get the range of modules to initialize.
     // This also determines the maximum version number of the library, which will be
     // referenced as `yend[-1].version`.
-    cow_dictionary<Value> ostd;
 #ifdef ROCKET_DEBUG
     ROCKET_ASSERT(::std::is_sorted(begin(s_modules), end(s_modules), Module_Comparator()));
 #endif
     auto bptr = begin(s_modules);
     auto eptr = ::std::upper_bound(bptr, end(s_modules), version, Module_Comparator());
+    ROCKET_ASSERT(eptr != bptr);
+
+    // Get the shared library, creating it if it hasn't been created yet. Copying
+    // it only increments a reference count. If it is modified afterwards, it is
+    // copied on write, so the shared one is never affected.
+    ::rocket::mutex::unique_lock lock(s_std_mutex);
+    auto& cached = s_std_cache[eptr - bptr - 1];
+    if(cached.empty())
+      cached = do_create_std(bptr, eptr);
+    auto ostd = cached;
+    lock.unlock();
 
-    // Initialize library modules.
-    for(auto q = bptr;  q != eptr;  ++q) {
-      // Create the subobject if it doesn't exist.
-      auto pair = ostd.try_emplace(sref(q->name));
-      if(pair.second) {
-        ROCKET_ASSERT(pair.first->second.is_null());
-        pair.first->second = cow_dictionary<Value>();
-      }
-      q->init(pair.first->second.open_object(), eptr[-1].version);
-    }
     auto vstd = gcoll->create_variable(gc_generation_oldest);
     vstd->initialize(::std::move(ostd), true);
 
@@ -115,9 +140,32 @@ Global_Context::
     const auto gcoll = unerase_cast<Genius_Collector*>(this->m_gcoll);
     ROCKET_ASSERT(gcoll);
 
-    // Perform the final garbage collection.
+    // Release all variables in bulk. This doesn't descend into values, so it
+    // costs much less than a collection. If a collection is in progress, fall
+    // back to wiping them out recursively.
     // Note if there are still cyclic references afterwards, they are left uncollected!
-    gcoll->wipe_out_variables();
+    if(!gcoll->release_variables())
+      gcoll->wipe_out_variables();
+  }
+
+Global_Context&
+Global_Context::
+take_snapshot()
+  {
+    this->m_snap = ::rocket::make_refcnt<Global_Snapshot>(*this);
+    return *this;
+  }
+
+Global_Context&
+Global_Context::
+reset_to_snapshot()
+  {
+    const auto snap = unerase_cast<Global_Snapshot*>(this->m_snap);
+    if(!snap)
+      ASTERIA_THROW("No snapshot has been taken");
+
+    snap->restore(*this);
+    return *this;
   }
 
 API_Version
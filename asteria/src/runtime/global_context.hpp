@@ -22,6 +22,11 @@ class Global_Context
     rcfwdp<Loader_Lock> m_ldrlk;
     rcfwdp<Variable> m_vstd;
 
+    rcfwdp<Sampling_Profiler> m_prof;
+    Sampling_Frame* m_sframe = nullptr;  // top of the shadow stack
+    rcfwdp<Node_Counters> m_ncount;
+    rcfwdp<Global_Snapshot> m_snap;
+
   public:
     // A global context has no parent.
     explicit
@@ -85,6 +90,59 @@ class Global_Context
       noexcept
       { return this->m_qhooks = ::std::move(hooks_opt), *this;  }
 
+    ASTERIA_INCOMPLET(Sampling_Profiler)
+    rcptr<Sampling_Profiler>
+    get_profiler_opt()
+      const noexcept
+      { return unerase_pointer_cast<Sampling_Profiler>(this->m_prof);  }
+
+    ASTERIA_INCOMPLET(Sampling_Profiler)
+    Global_Context&
+    set_profiler(rcptr<Sampling_Profiler> prof_opt)
+      noexcept
+      { return this->m_prof = ::std::move(prof_opt), *this;  }
+
+    Sampling_Frame*
+    get_sampling_frame_opt()
+      const noexcept
+      { return this->m_sframe;  }
+
+    Global_Context&
+    set_sampling_frame(Sampling_Frame* sframe_opt)
+      noexcept
+      { return this->m_sframe = sframe_opt, *this;  }
+
+    ASTERIA_INCOMPLET(Node_Counters)
+    rcptr<Node_Counters>
+    get_node_counters_opt()
+      const noexcept
+      { return unerase_pointer_cast<Node_Counters>(this->m_ncount);  }
+
+    ASTERIA_INCOMPLET(Node_Counters)
+    Global_Context&
+    set_node_counters(rcptr<Node_Counters> ncount_opt)
+      noexcept
+      { return this->m_ncount = ::std::move(ncount_opt), *this;  }
+
+    // A snapshot can be taken after a prelude has been loaded, and the context
+    // can be reset to it cheaply, instead of being created again.
+    ASTERIA_INCOMPLET(Global_Snapshot)
+    rcptr<Global_Snapshot>
+    get_snapshot_opt()
+      const noexcept
+      { return unerase_pointer_cast<Global_Snapshot>(this->m_snap);  }
+
+    Global_Context&
+    take_snapshot();
+
+    Global_Context&
+    reset_to_snapshot();
+
+    Global_Context&
+    discard_snapshot()
+      noexcept
+      { return this->m_snap.reset(), *this;  }
+
     // These are interfaces for individual global components.
     ASTERIA_INCOMPLET(Genius_Collector)
     rcptr<Genius_Collector>
@@ -0,0 +1,78 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "../precompiled.hpp"
+#include "global_snapshot.hpp"
+#include "abstract_context.hpp"
+#include "variable_callback.hpp"
+#include "../llds/variable_hashset.hpp"
+#include "../utils.hpp"
+
+namespace asteria {
+namespace {
+
+template<typename FuncT>
+class Variable_Walker
+  final
+  : public Variable_Callback
+  {
+  private:
+    ::std::reference_wrapper<FuncT> m_func;
+
+  public:
+    explicit
+    Variable_Walker(FuncT& func)
+      noexcept
+      : m_func(func)
+      { }
+
+  protected:
+    bool
+    do_process_one(const rcptr<Variable>& var)
+      override
+      { return this->m_func(var);  }
+  };
+
+}  // namespace
+
+Global_Snapshot::
+Global_Snapshot(const Abstract_Context& ctx)
+  : m_named_refs(ctx.get_named_references())
+  {
+    // Save all reachable variables, each exactly once.
+    Variable_HashSet seen;
+    auto save = [&](const rcptr<Variable>& var) {
+      if(!seen.insert(var))
+        return false;
+
+      this->m_vars.push_back({ var, var->get_value(), var->is_immutable(),
+                               var->is_initialized() });
+      return true;
+    };
+    Variable_Walker<decltype(save)> walker(save);
+    this->m_named_refs.enumerate_variables(walker);
+  }
+
+Global_Snapshot::
+~Global_Snapshot()
+  {
+  }
+
+const Global_Snapshot&
+Global_Snapshot::
+restore(Abstract_Context& ctx)
+  const
+  {
+    // Restore names first, which may throw exceptions.
+    ctx.set_named_references(this->m_named_refs);
+
+    for(const auto& r : this->m_vars) {
+      if(r.valid)
+        r.var->initialize(r.value, r.immut);
+      else
+        r.var->uninitialize();
+    }
+    return *this;
+  }
+
+}  // namespace asteria
@@ -0,0 +1,56 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_RUNTIME_GLOBAL_SNAPSHOT_HPP_
+#define ASTERIA_RUNTIME_GLOBAL_SNAPSHOT_HPP_
+
+#include "../fwd.hpp"
+#include "variable.hpp"
+#include "../llds/reference_dictionary.hpp"
+
+namespace asteria {
+
+// A snapshot records all names of a global context, and the values of all
+// variables that are reachable from them, including variables that have been
+// captured by closures. Values are copy-on-write, so taking a snapshot copies
+// no data other than handles.
+// Restoring a snapshot brings these variables back to their saved states in
+// place, so closures that have captured them see the saved states too.
+// Variables that have been created since are no longer reachable, and are left
+// to the garbage collector.
+class Global_Snapshot
+  final
+  : public Rcfwd<Global_Snapshot>
+  {
+  private:
+    struct Saved_Variable
+      {
+        rcptr<Variable> var;
+        Value value;
+        bool immut;
+        bool valid;
+      };
+
+    Reference_Dictionary m_named_refs;
+    cow_vector<Saved_Variable> m_vars;
+
+  public:
+    explicit
+    Global_Snapshot(const Abstract_Context& ctx);
+
+  public:
+    ASTERIA_NONCOPYABLE_DESTRUCTOR(Global_Snapshot);
+
+    size_t
+    count_variables()
+      const noexcept
+      { return this->m_vars.size();  }
+
+    const Global_Snapshot&
+    restore(Abstract_Context& ctx)
+      const;
+  };
+
+}  // namespace asteria
+
+#endif
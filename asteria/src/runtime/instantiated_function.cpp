@@ -23,7 +23,7 @@ void
 Instantiated_Function::
 do_solidify(const cow_vector<AIR_Node>& code)
   {
-    ::rocket::all_of(code, [&](const AIR_Node& node) { return node.solidify(this->m_queue);  });
+    AIR_Node::solidify_all(this->m_queue, code);
     this->m_queue.shrink_to_fit();
   }
 
@@ -0,0 +1,145 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "../precompiled.hpp"
+#include "node_counters.hpp"
+#include "../../rocket/mutex.hpp"
+#include "../utils.hpp"
+#include <time.h>  // ::clock_gettime()
+#if defined(__i386__) || defined(__x86_64__)
+#  include <x86intrin.h>  // __rdtsc()
+#endif
+
+namespace asteria {
+namespace {
+
+// Names of executors are shared by all counters. They are stored statically, as
+// executors are named before `main()` may return.
+struct Executor_Name
+  {
+    Node_Counters::Executor* exec;
+    Node_Counters::Namer* namer;
+    const char* state_opt;
+  };
+
+::rocket::mutex s_names_mutex;
+array<Executor_Name, 512> s_names;
+size_t s_nnames;
+
+inline
+size_t
+do_hash_executor(Node_Counters::Executor* exec)
+  noexcept
+  {
+    // Executors are functions, so the lowest few bits are hardly useful.
+    return static_cast<size_t>(reinterpret_cast<uintptr_t>(exec) >> 4) * 0x9E3779B9U;
+  }
+
+}  // namespace
+
+Node_Counters::
+~Node_Counters()
+  {
+  }
+
+void
+Node_Counters::
+name_executor(Executor* exec, Namer* namer, const char* state_opt)
+  {
+    ::rocket::mutex::unique_lock lock(s_names_mutex);
+    for(size_t k = 0;  k != s_nnames;  ++k)
+      if(s_names[k].exec == exec)
+        return;
+
+    // If the table is full, the executor is not named.
+    if(s_nnames == s_names.size())
+      return;
+
+    s_names[s_nnames++] = { exec, namer, state_opt };
+  }
+
+uint64_t
+Node_Counters::
+read_clock()
+  noexcept
+  {
+#if defined(__i386__) || defined(__x86_64__)
+    return __rdtsc();
+#else
+    ::timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + static_cast<uint64_t>(ts.tv_nsec);
+#endif
+  }
+
+void
+Node_Counters::
+leave(uint64_t saved, Executor* exec, uint64_t cycles)
+  noexcept
+  {
+    // Cycles of nested nodes are excluded from this node, but are counted towards
+    // the enclosing node.
+    uint64_t self = cycles - ::rocket::min(cycles, this->m_nested);
+    this->m_nested = saved + cycles;
+
+    // Locate the slot for this executor. If the table is full, the node is not
+    // counted.
+    size_t mask = this->m_slots.size() - 1;
+    size_t k = do_hash_executor(exec) & mask;
+    for(size_t n = 0;  n != this->m_slots.size();  ++n) {
+      auto& slot = this->m_slots[k];
+      if(slot.exec == nullptr)
+        slot.exec = exec;
+
+      if(slot.exec == exec) {
+        slot.count ++;
+        slot.cycles += self;
+        return;
+      }
+      k = (k + 1) & mask;
+    }
+  }
+
+cow_vector<Node_Counters::Record>
+Node_Counters::
+collect()
+  const
+  {
+    cow_vector<Record> records;
+    ::rocket::mutex::unique_lock lock(s_names_mutex);
+
+    for(const auto& slot : this->m_slots) {
+      if(slot.exec == nullptr)
+        continue;
+
+      // Get the name of this executor.
+      auto qname = ::std::find_if(s_names.begin(), s_names.begin() + s_nnames,
+                          [&](const Executor_Name& r) { return r.exec == slot.exec;  });
+
+      cow_string name = sref("[unknown]");
+      if(qname != s_names.begin() + s_nnames) {
+        name = qname->namer();
+        if(qname->state_opt)
+          name << " (" << qname->state_opt << ")";
+      }
+
+      // Merge executors of the same name.
+      size_t k = 0;
+      while((k != records.size()) && (records[k].name != name))
+        k++;
+
+      if(k == records.size())
+        records.push_back({ ::std::move(name), 0, 0 });
+
+      records.mut(k).count += slot.count;
+      records.mut(k).cycles += slot.cycles;
+    }
+    lock.unlock();
+
+    // Put the most expensive nodes first.
+    ::std::sort(records.mut_begin(), records.mut_end(),
+                [](const Record& x, const Record& y) { return x.cycles > y.cycles;  });
+    return records;
+  }
+
+}  // namespace asteria
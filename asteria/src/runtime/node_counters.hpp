@@ -0,0 +1,100 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_RUNTIME_NODE_COUNTERS_HPP_
+#define ASTERIA_RUNTIME_NODE_COUNTERS_HPP_
+
+#include "../fwd.hpp"
+#include "../llds/avmc_queue.hpp"
+
+namespace asteria {
+
+// These counters record the number of executions and the number of cycles that
+// have been spent in each kind of AVMC node. When a set of counters is installed
+// into a global context, every AVMC queue that is executed in it updates them.
+// Functions are not translated into native code in this mode, so all nodes are
+// counted. Cycles of nested queues are not counted towards their parent nodes.
+class Node_Counters
+  final
+  : public Rcfwd<Node_Counters>
+  {
+  public:
+    using Executor  = details_avmc_queue::Executor;
+    using Namer     = cow_string ();
+
+    struct Record
+      {
+        cow_string name;
+        uint64_t count;
+        uint64_t cycles;
+      };
+
+  private:
+    struct Slot
+      {
+        Executor* exec;
+        uint64_t count;
+        uint64_t cycles;
+      };
+
+    // This is a hash table with linear probing, indexed by executors.
+    array<Slot, 512> m_slots = { };
+    uint64_t m_nested = 0;  // cycles of nested nodes
+
+  public:
+    explicit
+    Node_Counters()
+      noexcept
+      { }
+
+  public:
+    ASTERIA_NONCOPYABLE_DESTRUCTOR(Node_Counters);
+
+    // Executors are named when they are appended to AVMC queues. Names are only
+    // composed when counters are collected, as `<name>` or `<name> (<state>)`.
+    // Executors without names are reported as `[unknown]`.
+    static
+    void
+    name_executor(Executor* exec, Namer* namer, const char* state_opt = nullptr);
+
+    // Read the clock for timing. This is the time stamp counter on x86.
+    static
+    uint64_t
+    read_clock()
+      noexcept;
+
+    // These are called by the runtime. `enter()` returns the cycles of nested
+    // nodes so far, which shall be passed to `leave()` afterwards.
+    uint64_t
+    enter()
+      noexcept
+      {
+        uint64_t saved = this->m_nested;
+        this->m_nested = 0;
+        return saved;
+      }
+
+    void
+    leave(uint64_t saved, Executor* exec, uint64_t cycles)
+      noexcept;
+
+    // These are interfaces for the embedder.
+    Node_Counters&
+    clear()
+      noexcept
+      {
+        this->m_slots.fill(Slot());
+        this->m_nested = 0;
+        return *this;
+      }
+
+    // Get counters of nodes that have been executed, with executors of the same
+    // name merged. Results are sorted by cycles in descending order.
+    cow_vector<Record>
+    collect()
+      const;
+  };
+
+}  // namespace asteria
+
+#endif
@@ -118,7 +118,36 @@ class Reference
         return *this;  }
 
   public:
-    ASTERIA_COPYABLE_DESTRUCTOR(Reference);
+    Reference(const Reference&) = default;
+    Reference(Reference&&) noexcept = default;
+
+    // References on the stack are overwritten over and over again. If the source
+    // has no modifiers, storage for ours is kept, so subsequent member accesses
+    // and subscripts don't allocate.
+    Reference&
+    operator=(const Reference& other)
+      {
+        this->m_root = other.m_root;
+        if(ROCKET_EXPECT(other.m_mods.empty()))
+          this->m_mods.clear();
+        else
+          this->m_mods = other.m_mods;
+        return *this;
+      }
+
+    Reference&
+    operator=(Reference&& other)
+      noexcept
+      {
+        this->m_root = ::std::move(other.m_root);
+        if(ROCKET_EXPECT(other.m_mods.empty()))
+          this->m_mods.clear();
+        else
+          this->m_mods = ::std::move(other.m_mods);
+        return *this;
+      }
+
+    ~Reference();
 
     Index
     index()
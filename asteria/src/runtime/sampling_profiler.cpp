@@ -0,0 +1,168 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "../precompiled.hpp"
+#include "sampling_profiler.hpp"
+#include "variadic_arguer.hpp"
+#include "../../rocket/mutex.hpp"
+#include "../utils.hpp"
+#include <signal.h>  // ::sigaction()
+#include <sys/time.h>  // ::setitimer()
+
+namespace asteria {
+namespace {
+
+// The timer and the signal handler are shared by all profilers.
+::rocket::mutex s_timer_mutex;
+size_t s_timer_users;
+struct ::sigaction s_old_action;
+struct ::itimerval s_old_timer;
+
+}  // namespace
+
+::rocket::atomic<bool> Sampling_Profiler::s_pending;
+
+Sampling_Profiler::
+~Sampling_Profiler()
+  {
+    this->stop();
+  }
+
+void
+Sampling_Profiler::
+do_on_timer(int /*sig*/)
+  noexcept
+  {
+    s_pending.store(true);
+  }
+
+void
+Sampling_Profiler::
+do_record(const Sampling_Frame* qframe)
+  {
+    // Collect frames from the innermost one. Frames of blocks in the same function
+    // are merged, where the innermost node is the one being executed.
+    cow_vector<cow_string> frames;
+    const Executive_Context* qfunc_last = nullptr;
+
+    while(qframe) {
+      auto qfunc = &(qframe->context());
+      while(auto qparent = qfunc->get_parent_opt())
+        qfunc = qparent;
+
+      if(qfunc != qfunc_last) {
+        auto& str = frames.emplace_back();
+        ::rocket::tinyfmt_str fmt;
+        auto zvarg = qfunc->get_zvarg_opt();
+        if(zvarg)
+          fmt << zvarg->func();
+        else
+          fmt << "[deferred]";
+
+        auto qnode = qframe->get_node_opt();
+        auto qsyms = qnode ? qnode->get_symbols_opt() : nullptr;
+        if(qsyms)
+          fmt << " [" << qsyms->sloc << "]";
+        else if(zvarg)
+          fmt << " [" << zvarg->sloc() << "]";
+        str = fmt.extract_string();
+        qfunc_last = qfunc;
+      }
+      qframe = qframe->get_prev_opt();
+    }
+    if(frames.empty())
+      return;
+
+    // Compose the folded stack, from the outermost frame to the innermost one.
+    cow_string stack = ::std::move(frames.mut_back());
+    for(size_t k = frames.size() - 1;  k != 0;  --k)
+      stack << ';' << frames[k - 1];
+
+    this->m_stacks.try_emplace(::std::move(stack), UINT64_C(0)).first->second++;
+    this->m_nsamples++;
+  }
+
+void
+Sampling_Profiler::
+take_sample(Global_Context& global)
+  {
+    // Only a global context with a profiler consumes the sample.
+    auto prof = global.get_profiler_opt();
+    if(!prof || !prof->m_running)
+      return;
+
+    if(!s_pending.exchange(false))
+      return;
+
+    prof->do_record(global.get_sampling_frame_opt());
+  }
+
+Sampling_Profiler&
+Sampling_Profiler::
+start(uint32_t interval_us)
+  {
+    if(this->m_running)
+      return *this;
+
+    if(interval_us == 0)
+      ASTERIA_THROW("Invalid sampling interval (interval_us `$1`)", interval_us);
+
+    ::rocket::mutex::unique_lock lock(s_timer_mutex);
+    if(s_timer_users == 0) {
+      // Install the signal handler, then start the timer.
+      struct ::sigaction sigx = { };
+      sigx.sa_handler = do_on_timer;
+      sigx.sa_flags = SA_RESTART;
+      if(::sigaction(SIGPROF, &sigx, &s_old_action) != 0)
+        ASTERIA_THROW("Could not install signal handler for `SIGPROF`\n"
+                      "[`sigaction()` failed: $1]",
+                      format_errno(errno));
+
+      struct ::itimerval itv = { };
+      itv.it_interval.tv_sec = static_cast<time_t>(interval_us / 1000000);
+      itv.it_interval.tv_usec = static_cast<suseconds_t>(interval_us % 1000000);
+      itv.it_value = itv.it_interval;
+      if(::setitimer(ITIMER_PROF, &itv, &s_old_timer) != 0) {
+        int err = errno;
+        ::sigaction(SIGPROF, &s_old_action, nullptr);
+        ASTERIA_THROW("Could not start profiling timer\n"
+                      "[`setitimer()` failed: $1]",
+                      format_errno(err));
+      }
+    }
+    s_timer_users++;
+    this->m_running = true;
+    return *this;
+  }
+
+Sampling_Profiler&
+Sampling_Profiler::
+stop()
+  noexcept
+  {
+    if(!this->m_running)
+      return *this;
+
+    ::rocket::mutex::unique_lock lock(s_timer_mutex);
+    ROCKET_ASSERT(s_timer_users != 0);
+    if(--s_timer_users == 0) {
+      // Stop the timer, then restore the old signal handler.
+      ::setitimer(ITIMER_PROF, &s_old_timer, nullptr);
+      ::sigaction(SIGPROF, &s_old_action, nullptr);
+      s_pending.store(false);
+    }
+    this->m_running = false;
+    return *this;
+  }
+
+tinyfmt&
+Sampling_Profiler::
+print_folded(tinyfmt& fmt)
+  const
+  {
+    for(const auto& r : this->m_stacks)
+      fmt << r.first << ' ' << r.second << '\n';
+    return fmt;
+  }
+
+}  // namespace asteria
@@ -0,0 +1,160 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_RUNTIME_SAMPLING_PROFILER_HPP_
+#define ASTERIA_RUNTIME_SAMPLING_PROFILER_HPP_
+
+#include "../fwd.hpp"
+#include "global_context.hpp"
+#include "executive_context.hpp"
+#include "../llds/avmc_queue.hpp"
+#include "../../rocket/atomic.hpp"
+
+namespace asteria {
+
+// Each execution of an AVMC queue pushes a frame onto the shadow stack of its
+// global context, which records the node that is being executed. This allows
+// backtraces to be taken without unwinding the native stack.
+class Sampling_Frame
+  {
+  private:
+    using Header  = details_avmc_queue::Header;
+
+    Global_Context* m_global;
+    Sampling_Frame* m_prev;
+    const Executive_Context* m_ctx;
+    const Header* m_qnode = nullptr;
+
+  public:
+    explicit
+    Sampling_Frame(const Executive_Context& ctx)
+      noexcept
+      : m_global(::std::addressof(ctx.global())),
+        m_prev(this->m_global->get_sampling_frame_opt()),
+        m_ctx(::std::addressof(ctx))
+      { this->m_global->set_sampling_frame(this);  }
+
+    Sampling_Frame(const Sampling_Frame&)
+      = delete;
+
+    Sampling_Frame&
+    operator=(const Sampling_Frame&)
+      = delete;
+
+    ~Sampling_Frame()
+      { this->m_global->set_sampling_frame(this->m_prev);  }
+
+  public:
+    const Sampling_Frame*
+    get_prev_opt()
+      const noexcept
+      { return this->m_prev;  }
+
+    const Executive_Context&
+    context()
+      const noexcept
+      { return *(this->m_ctx);  }
+
+    const Header*
+    get_node_opt()
+      const noexcept
+      { return this->m_qnode;  }
+
+    Sampling_Frame&
+    set_node(const Header* qnode)
+      noexcept
+      { return this->m_qnode = qnode, *this;  }
+
+    // Native code stores the current node here.
+    const Header**
+    node_ptr()
+      noexcept
+      { return &(this->m_qnode);  }
+  };
+
+// This is a sampling profiler. When it is running, a timer on the CPU time of
+// the process fires periodically, and the next node that finishes execution in
+// a global context where this profiler has been installed takes a sample of
+// its shadow stack. Samples are accumulated as folded stacks, which can be fed
+// to flame graph tools directly.
+// The timer is shared by all profilers in a process, and its interval is set
+// by the first profiler that starts.
+class Sampling_Profiler
+  final
+  : public Rcfwd<Sampling_Profiler>
+  {
+  private:
+    static ::rocket::atomic<bool> s_pending;
+
+    cow_dictionary<uint64_t> m_stacks;  // folded stacks and their counts
+    uint64_t m_nsamples = 0;
+    bool m_running = false;
+
+  public:
+    explicit
+    Sampling_Profiler()
+      noexcept
+      { }
+
+  private:
+    static
+    void
+    do_on_timer(int sig)
+      noexcept;
+
+    void
+    do_record(const Sampling_Frame* qframe);
+
+  public:
+    ASTERIA_NONCOPYABLE_DESTRUCTOR(Sampling_Profiler);
+
+    // These are called by the runtime. The check for pending samples shall be
+    // as cheap as possible.
+    static
+    bool
+    is_sample_pending()
+      noexcept
+      { return s_pending.load();  }
+
+    static
+    void
+    take_sample(Global_Context& global);
+
+    // These are interfaces for the embedder.
+    bool
+    is_running()
+      const noexcept
+      { return this->m_running;  }
+
+    uint64_t
+    count_samples()
+      const noexcept
+      { return this->m_nsamples;  }
+
+    Sampling_Profiler&
+    start(uint32_t interval_us = 10000);
+
+    Sampling_Profiler&
+    stop()
+      noexcept;
+
+    Sampling_Profiler&
+    clear()
+      noexcept
+      {
+        this->m_stacks.clear();
+        this->m_nsamples = 0;
+        return *this;
+      }
+
+    // Write folded stacks, one per line. Each line contains frames from the
+    // outermost one to the innermost one, separated by semicolons, followed by
+    // a space and the number of samples.
+    tinyfmt&
+    print_folded(tinyfmt& fmt)
+      const;
+  };
+
+}  // namespace asteria
+
+#endif
@@ -3,13 +3,292 @@
 
 #include "../precompiled.hpp"
 #include "variable.hpp"
+#include "collector.hpp"
 #include "../utils.hpp"
+#include <sched.h>  // ::sched_yield()
+#include <pthread.h>
 
 namespace asteria {
+namespace {
+
+struct Page;
+
+struct Slot
+  {
+    Page* page;  // the page that contains this slot
+    union {
+      Slot* next;
+      ::std::aligned_storage<sizeof(Variable), alignof(Variable)>::type storage;
+    };
+  };
+
+enum : size_t
+  {
+    slots_per_page  = 1024,
+    batch_size      = 64,   // number of slots that are moved at a time
+    cache_max       = 256,  // maximum number of free slots of a thread
+  };
+
+struct Page
+  {
+    Page* prev;  // in the list of pages with free slots
+    Page* next;
+    Slot* free;  // slots that have been returned
+    size_t nbump;  // slots that have been handed out at least once
+    size_t nused;  // slots that are in use or cached by threads
+    Slot slots[slots_per_page];
+  };
+
+// These are shared by all threads, and are protected by a spin lock. These are
+// trivial, so they are still usable when threads exit after `main()`.
+bool s_lock;
+Page* s_avail;  // pages with free slots
+size_t s_nused;  // sum of `nused` of all pages
+
+void
+do_lock()
+  noexcept
+  {
+    while(__atomic_exchange_n(&s_lock, true, __ATOMIC_ACQUIRE))
+      ::sched_yield();
+  }
+
+void
+do_unlock()
+  noexcept
+  {
+    __atomic_store_n(&s_lock, false, __ATOMIC_RELEASE);
+  }
+
+void
+do_link_page(Page* page)
+  noexcept
+  {
+    page->prev = nullptr;
+    page->next = s_avail;
+    if(s_avail)
+      s_avail->prev = page;
+    s_avail = page;
+  }
+
+void
+do_unlink_page(Page* page)
+  noexcept
+  {
+    if(page->prev)
+      page->prev->next = page->next;
+    else
+      s_avail = page->next;
+    if(page->next)
+      page->next->prev = page->prev;
+  }
+
+struct Slot_Cache
+  {
+    Slot* free;
+    size_t nfree;
+    bool registered;  // whether `flush_all()` will be called at thread exit
+
+    void
+    flush(size_t count)
+      noexcept
+      {
+        // Return `count` slots from the front to their pages. Pages that become
+        // empty are released, so memory is not kept after peaks.
+        Page* empty = nullptr;
+
+        do_lock();
+        for(size_t k = 0;  k != count;  ++k) {
+          Slot* slot = this->free;
+          this->free = slot->next;
+          this->nfree--;
+
+          Page* page = slot->page;
+          if(!page->free && (page->nbump == slots_per_page))
+            do_link_page(page);
+          slot->next = page->free;
+          page->free = slot;
+
+          s_nused--;
+          if(--(page->nused) != 0)
+            continue;
+
+          do_unlink_page(page);
+          page->next = empty;
+          empty = page;
+        }
+        do_unlock();
+
+        while(empty) {
+          Page* page = empty;
+          empty = page->next;
+          ::operator delete(page);
+        }
+      }
+
+    void
+    flush_all()
+      noexcept
+      {
+        this->flush(this->nfree);
+      }
+
+    void
+    refill()
+      {
+        // Take a batch of slots from pages with free slots, if there are any.
+        // They are kept in order, so new slots are handed out in address order.
+        ROCKET_ASSERT(!this->free);
+        Slot** tail = &(this->free);
+
+        do_lock();
+        while(s_avail && (this->nfree < batch_size)) {
+          Page* page = s_avail;
+          Slot* slot = page->free;
+          if(slot)
+            page->free = slot->next;
+          else
+            slot = page->slots + page->nbump++;
+          page->nused++;
+          s_nused++;
+
+          if(!page->free && (page->nbump == slots_per_page))
+            do_unlink_page(page);
+          *tail = slot;
+          tail = &(slot->next);
+          this->nfree++;
+        }
+        do_unlock();
+
+        *tail = nullptr;
+        if(this->free)
+          return;
+
+        // Allocate a new page.
+        Page* page = static_cast<Page*>(::operator new(sizeof(Page)));
+        page->free = nullptr;
+        page->nbump = 0;
+        page->nused = 0;
+        for(size_t k = 0;  k != slots_per_page;  ++k)
+          page->slots[k].page = page;
+
+        do_lock();
+        do_link_page(page);
+        do_unlock();
+        this->refill();
+      }
+  };
+
+// The cache is trivially destructible, so variables can still be freed after
+// thread-local objects have been destroyed, which, in the main thread, happens
+// before static objects are destroyed. Other threads return their slots from
+// the destructor of a thread-specific key, which is not called for the main
+// thread, whose slots are simply dropped when the process exits.
+thread_local Slot_Cache s_cache;
+::pthread_once_t s_key_once = PTHREAD_ONCE_INIT;
+::pthread_key_t s_key;
+
+void
+do_flush_cache(void* param)
+  noexcept
+  {
+    // If more slots are freed by this thread afterwards, the key is set again,
+    // and this function will be called again.
+    auto& cache = *static_cast<Slot_Cache*>(param);
+    cache.registered = false;
+    cache.flush_all();
+  }
+
+void
+do_create_key()
+  noexcept
+  {
+    int err = ::pthread_key_create(&s_key, do_flush_cache);
+    if(err != 0)
+      ASTERIA_TERMINATE("could not create key for variable slots\n"
+                        "[`pthread_key_create()` failed: $1]",
+                        format_errno(err));
+  }
+
+void
+do_register_cache(Slot_Cache& cache)
+  noexcept
+  {
+    ::pthread_once(&s_key_once, do_create_key);
+    ::pthread_setspecific(s_key, &cache);
+    cache.registered = true;
+  }
+
+}  // namespace
+
+void*
+Variable::
+operator new(size_t size)
+  {
+    ROCKET_ASSERT(size == sizeof(Variable));
+    auto& cache = s_cache;
+
+    // Take a slot from this thread, or get a batch of slots if there is none.
+    if(ROCKET_UNEXPECT(!cache.free)) {
+      if(ROCKET_UNEXPECT(!cache.registered))
+        do_register_cache(cache);
+      cache.refill();
+    }
+
+    Slot* slot = cache.free;
+    cache.free = slot->next;
+    cache.nfree--;
+    return ::std::addressof(slot->storage);
+  }
+
+void
+Variable::
+operator delete(void* ptr)
+  noexcept
+  {
+    if(!ptr)
+      return;
+
+    // The slot is cached by the thread that deallocates it, which need not be
+    // the thread that allocated it.
+    auto& cache = s_cache;
+    Slot* slot = reinterpret_cast<Slot*>(static_cast<char*>(ptr) - offsetof(Slot, storage));
+    slot->next = cache.free;
+    cache.free = slot;
+    cache.nfree++;
+
+    if(ROCKET_UNEXPECT(!cache.registered))
+      do_register_cache(cache);
+    if(ROCKET_UNEXPECT(cache.nfree > cache_max))
+      cache.flush(cache_max - batch_size);
+  }
+
+size_t
+Variable::
+count_allocated()
+  noexcept
+  {
+    do_lock();
+    size_t count = s_nused;
+    do_unlock();
+    return count - s_cache.nfree;
+  }
 
 Variable::
 ~Variable()
   {
+    // A variable in a list is owned by the list.
+    ROCKET_ASSERT(!this->m_gc_list);
+  }
+
+void
+Variable::
+do_track_lazily()
+  {
+    // This variable is owned by the lazy list, so it can't be destroyed here.
+    this->add_reference();
+    rcptr<Variable> self(this);
+    this->m_gc_lazy->activate_lazy_variable(self);
   }
 
 Variable_Callback&
@@ -18,23 +18,62 @@ class Variable
     bool m_immut = false;
     bool m_valid = false;
 
-    // These are fields for garbage collection and are uninitialized by
-    // default. Because values are reference-counted, it is possible for
-    // a variable to be encountered multiple times at the marking stage
-    // during garbage collection. It is essential that we mark the value
-    // exactly once.
-    bool m_gc_mark;
+    // These are fields for garbage collection. Because values are reference-
+    // counted, it is possible for a variable to be encountered multiple times
+    // when the staging area is being built. It is essential that we stage the
+    // variable exactly once.
+    bool m_gc_staged = false;
     long m_gc_ref;
 
+    // These are links of the list of variables which are tracked by the same
+    // collector. See 'llds/variable_list.hpp'.
+    friend Variable_List;
+    Variable_List* m_gc_list = nullptr;
+    Variable* m_gc_prev = nullptr;
+    rcptr<Variable> m_gc_next;
+    uint32_t m_gc_pass;
+
+    // If this is not null, this variable is on the lazy list of this collector,
+    // as it has only held scalar values, which can't form cycles. It is moved
+    // to the tracked list when it is initialized with a value that is not, or
+    // when the collector finds such a value in it. The collector resets this
+    // pointer when the variable leaves its lazy list.
+    Collector* m_gc_lazy = nullptr;
+
   public:
     explicit
     Variable()
       noexcept
       { }
 
+  private:
+    void
+    do_track_lazily();
+
   public:
     ASTERIA_NONCOPYABLE_DESTRUCTOR(Variable);
 
+    // Variables are allocated from pages, which are divided into slots of the
+    // same size. Each thread has its own list of free slots, which it takes from
+    // pages and returns to pages in batches. Pages are released when all their
+    // slots have been returned.
+    static
+    void*
+    operator new(size_t size);
+
+    static
+    void
+    operator delete(void* ptr)
+      noexcept;
+
+    // Get the number of variables that have been allocated but not freed. Free
+    // slots that are cached by other threads are counted as well, so this is
+    // only exact if no other thread has freed variables.
+    static
+    size_t
+    count_allocated()
+      noexcept;
+
     const Value&
     get_value()
       const noexcept
@@ -42,6 +81,7 @@ class Variable
 
     Value&
     open_value()
+      noexcept
       { return this->m_value;  }
 
     bool
@@ -66,6 +106,9 @@ class Variable
         this->m_value = ::std::forward<XValT>(xval);
         this->m_immut = immut;
         this->m_valid = true;
+
+        if(ROCKET_UNEXPECT(this->m_gc_lazy) && !this->m_value.is_scalar())
+          this->do_track_lazily();
         return *this;
       }
 
@@ -87,20 +130,54 @@ class Variable
     Variable&
     reset_gc_ref(long ref)
       noexcept
-      {
-        this->m_gc_mark = false;
-        this->m_gc_ref = ref;
-        return *this;
-      }
+      { return this->m_gc_ref = ref, *this;  }
 
-    bool
+    Variable&
     add_gc_ref()
       noexcept
-      {
-        bool m = ::std::exchange(this->m_gc_mark, true);
-        this->m_gc_ref += 1;
-        return m;
-      }
+      { return this->m_gc_ref += 1, *this;  }
+
+    bool
+    is_gc_lazy()
+      const noexcept
+      { return this->m_gc_lazy != nullptr;  }
+
+    Variable&
+    set_gc_lazy(Collector* coll)
+      noexcept
+      { return this->m_gc_lazy = coll, *this;  }
+
+    bool
+    is_gc_tracked()
+      const noexcept
+      { return this->m_gc_list != nullptr;  }
+
+    bool
+    is_gc_staged()
+      const noexcept
+      { return this->m_gc_staged;  }
+
+    Variable&
+    set_gc_staged(bool staged)
+      noexcept
+      { return this->m_gc_staged = staged, *this;  }
+
+    // These are used by parallel collection, where `gc_ref` counters may be
+    // updated by multiple threads concurrently.
+    void
+    add_gc_ref_concurrent()
+      noexcept
+      { __atomic_fetch_add(&(this->m_gc_ref), 1L, __ATOMIC_RELAXED);  }
+
+    long
+    load_gc_ref_concurrent()
+      const noexcept
+      { return __atomic_load_n(&(this->m_gc_ref), __ATOMIC_RELAXED);  }
+
+    long
+    exchange_gc_ref_concurrent(long ref)
+      noexcept
+      { return __atomic_exchange_n(&(this->m_gc_ref), ref, __ATOMIC_RELAXED);  }
 
     Variable_Callback&
     enumerate_variables_descent(Variable_Callback& callback)
@@ -0,0 +1,314 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "precompiled.hpp"
+#include "script_pool.hpp"
+#include "compiler/token_stream.hpp"
+#include "compiler/statement_sequence.hpp"
+#include "compiler/statement.hpp"
+#include "compiler/expression_unit.hpp"
+#include "runtime/global_context.hpp"
+#include "runtime/reference.hpp"
+#include "llds/reference_stack.hpp"
+#include "utils.hpp"
+
+namespace asteria {
+
+struct Script_Pool::Instance
+  {
+    Global_Context global;
+    cow_function func;
+    uint64_t serial;
+    uptr<Instance> next;
+
+    explicit
+    Instance(API_Version version, const cow_function& xfunc, uint64_t xserial)
+      : global(version),
+        func(xfunc), serial(xserial)
+      { }
+  };
+
+Script_Pool::
+Script_Pool(const Compiler_Options& opts, API_Version version)
+  : m_optmz(opts), m_version(version)
+  { }
+
+Script_Pool::
+~Script_Pool()
+  {
+    // Destroy idle instances one by one, as recursion might overflow the stack.
+    while(auto inst = ::std::move(this->m_idle))
+      this->m_idle = ::std::move(inst->next);
+  }
+
+void
+Script_Pool::
+do_release(uptr<Instance>&& inst)
+  noexcept
+  {
+    ::rocket::mutex::unique_lock lock(this->m_mutex);
+    if((inst->serial != this->m_serial) || (this->m_nidle >= this->m_max_idle))
+      return;  // `inst` is destroyed by the caller without locking.
+
+    inst->next = ::std::move(this->m_idle);
+    this->m_idle = ::std::move(inst);
+    this->m_nidle++;
+  }
+
+Compiler_Options
+Script_Pool::
+get_options()
+  const
+  {
+    ::rocket::mutex::unique_lock lock(this->m_mutex);
+    return this->m_optmz.get_options();
+  }
+
+Script_Pool&
+Script_Pool::
+set_options(const Compiler_Options& opts)
+  {
+    ::rocket::mutex::unique_lock lock(this->m_mutex);
+    this->m_optmz.set_options(opts);
+    return *this;
+  }
+
+size_t
+Script_Pool::
+get_max_idle()
+  const
+  {
+    ::rocket::mutex::unique_lock lock(this->m_mutex);
+    return this->m_max_idle;
+  }
+
+Script_Pool&
+Script_Pool::
+set_max_idle(size_t max_idle)
+  {
+    uptr<Instance> idle;
+    ::rocket::mutex::unique_lock lock(this->m_mutex);
+    this->m_max_idle = max_idle;
+
+    // Detach excess instances, which are destroyed after `lock`.
+    while(this->m_nidle > max_idle) {
+      auto inst = ::std::move(this->m_idle);
+      this->m_idle = ::std::move(inst->next);
+      inst->next = ::std::move(idle);
+      idle = ::std::move(inst);
+      this->m_nidle--;
+    }
+    lock.unlock();
+
+    while(auto inst = ::std::move(idle))
+      idle = ::std::move(inst->next);
+    return *this;
+  }
+
+size_t
+Script_Pool::
+count_idle()
+  const
+  {
+    ::rocket::mutex::unique_lock lock(this->m_mutex);
+    return this->m_nidle;
+  }
+
+Script_Pool::
+operator bool()
+  const
+  {
+    ::rocket::mutex::unique_lock lock(this->m_mutex);
+    return !this->m_name.empty();
+  }
+
+Script_Pool&
+Script_Pool::
+reload(const cow_string& name, int line, tinybuf& cbuf)
+  {
+    // Compile the script without locking the pool.
+    AIR_Optimizer optmz(this->get_options());
+    Token_Stream tstrm(optmz.get_options());
+    tstrm.reload(name, line, cbuf);
+
+    Statement_Sequence stmtq(optmz.get_options());
+    stmtq.reload(tstrm);
+
+    // A script is a variadic function.
+    cow_vector<phsh_string> params;
+    params.emplace_back(sref("..."));
+    optmz.reload(nullptr, params, stmtq);
+
+    // Replace the shared code, then detach idle instances, which are destroyed
+    // after `lock`.
+    ::rocket::mutex::unique_lock lock(this->m_mutex);
+    this->m_optmz = ::std::move(optmz);
+    this->m_name = name;
+    this->m_serial++;
+
+    auto idle = ::std::move(this->m_idle);
+    this->m_nidle = 0;
+    lock.unlock();
+
+    while(auto inst = ::std::move(idle))
+      idle = ::std::move(inst->next);
+    return *this;
+  }
+
+Script_Pool&
+Script_Pool::
+reload_string(const cow_string& name, const cow_string& code)
+  {
+    return this->reload_string(name, 1, code);
+  }
+
+Script_Pool&
+Script_Pool::
+reload_string(const cow_string& name, int line, const cow_string& code)
+  {
+    ::rocket::tinybuf_str cbuf;
+    cbuf.set_string(code, tinybuf::open_read);
+    return this->reload(name, line, cbuf);
+  }
+
+Script_Pool&
+Script_Pool::
+reload_file(const char* path)
+  {
+    // Resolve the path to an absolute one.
+    auto abspath = ::rocket::make_unique_handle(::realpath(path, nullptr), ::free);
+    if(!abspath)
+      ASTERIA_THROW("Could not open script file '$2'\n"
+                    "[`realpath()` failed: $1]",
+                    format_errno(errno), path);
+
+    // Open the file denoted by this path.
+    ::rocket::tinybuf_file cbuf;
+    cbuf.open(abspath, tinybuf::open_read);
+    return this->reload(cow_string(abspath), 1, cbuf);
+  }
+
+Script_Pool::Lease
+Script_Pool::
+acquire()
+  {
+    ::rocket::mutex::unique_lock lock(this->m_mutex);
+    if(this->m_name.empty())
+      ASTERIA_THROW("No script has been loaded");
+
+    // Reuse an idle instance if one is available.
+    if(auto inst = ::std::move(this->m_idle)) {
+      this->m_idle = ::std::move(inst->next);
+      this->m_nidle--;
+      return Lease(this, ::std::move(inst));
+    }
+
+    // Copy the shared code, which only increments reference counts. The function
+    // is instantiated without locking the pool, with its own AVMC queue.
+    auto optmz = this->m_optmz;
+    const Source_Location sloc(this->m_name, 0, 0);
+    uint64_t serial = this->m_serial;
+    lock.unlock();
+
+    auto func = optmz.create_function(sloc, sref("[file scope]"));
+    return Lease(this, ::rocket::make_unique<Instance>(this->m_version, func, serial));
+  }
+
+Script_Pool::Lease::
+Lease()
+  noexcept
+  { }
+
+Script_Pool::Lease::
+Lease(Script_Pool* pool, uptr<Instance>&& inst)
+  noexcept
+  : m_pool(pool), m_inst(::std::move(inst))
+  { }
+
+Script_Pool::Lease::
+Lease(Lease&& other)
+  noexcept
+  : m_pool(other.m_pool), m_inst(::std::move(other.m_inst))
+  { }
+
+Script_Pool::Lease&
+Script_Pool::Lease::
+operator=(Lease&& other)
+  noexcept
+  {
+    this->release();
+    this->m_pool = other.m_pool;
+    this->m_inst = ::std::move(other.m_inst);
+    return *this;
+  }
+
+Script_Pool::Lease::
+~Lease()
+  {
+    this->release();
+  }
+
+Global_Context&
+Script_Pool::Lease::
+global()
+  const
+  {
+    if(!this->m_inst)
+      ASTERIA_THROW("No instance has been leased");
+
+    return this->m_inst->global;
+  }
+
+const cow_function&
+Script_Pool::Lease::
+function()
+  const
+  {
+    if(!this->m_inst)
+      ASTERIA_THROW("No instance has been leased");
+
+    return this->m_inst->func;
+  }
+
+Reference
+Script_Pool::Lease::
+execute(Reference_Stack&& stack)
+  const
+  {
+    if(!this->m_inst)
+      ASTERIA_THROW("No instance has been leased");
+
+    // Execute the script as a plain function. The instance may have been created
+    // in another thread, so the stack overflow protection has to be rebased.
+    Reference self = Reference::S_constant();
+    this->m_inst->global.set_recursion_base(&self);
+    this->m_inst->func.invoke(self, this->m_inst->global, ::std::move(stack));
+    return self;
+  }
+
+Reference
+Script_Pool::Lease::
+execute(cow_vector<Value>&& vals)
+  const
+  {
+    // Push all arguments backwards as temporaries.
+    Reference_Stack stack;
+    for(auto it = vals.mut_rbegin();  it != vals.rend();  ++it) {
+      Reference::S_temporary xref = { ::std::move(*it) };
+      stack.emplace_back(::std::move(xref));
+    }
+    return this->execute(::std::move(stack));
+  }
+
+Script_Pool::Lease&
+Script_Pool::Lease::
+release(bool discard)
+  noexcept
+  {
+    auto inst = ::std::move(this->m_inst);
+    if(inst && !discard)
+      this->m_pool->do_release(::std::move(inst));
+    return *this;
+  }
+
+}  // namespace asteria
@@ -0,0 +1,155 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_SCRIPT_POOL_HPP_
+#define ASTERIA_SCRIPT_POOL_HPP_
+
+#include "fwd.hpp"
+#include "runtime/air_optimizer.hpp"
+#include "../rocket/mutex.hpp"
+
+namespace asteria {
+
+// A script pool compiles a script once, and then executes it concurrently in
+// multiple threads. Compiled code is immutable and is shared by all threads.
+// Each instance in the pool has its own global context, and its own copy of the
+// function, because AVMC queues are modified as they are executed. Instances
+// are leased to threads one at a time, and are reused after they are returned,
+// so global variables may persist across executions.
+// All functions of this class are thread-safe.
+class Script_Pool
+  {
+  public:
+    class Lease;
+
+  private:
+    struct Instance;
+
+    mutable ::rocket::mutex m_mutex;
+    AIR_Optimizer m_optmz;  // shared code
+    API_Version m_version;
+    cow_string m_name;
+    uint64_t m_serial = 0;  // incremented by `reload()`
+    size_t m_max_idle = 64;
+
+    uptr<Instance> m_idle;  // singly linked list
+    size_t m_nidle = 0;
+
+  public:
+    explicit
+    Script_Pool(const Compiler_Options& opts = { }, API_Version version = api_version_latest);
+
+  private:
+    void
+    do_release(uptr<Instance>&& inst)
+      noexcept;
+
+  public:
+    ASTERIA_NONCOPYABLE_DESTRUCTOR(Script_Pool);
+
+    Compiler_Options
+    get_options()
+      const;
+
+    Script_Pool&
+    set_options(const Compiler_Options& opts);
+
+    // Idle instances more than this number are destroyed when they are returned.
+    size_t
+    get_max_idle()
+      const;
+
+    Script_Pool&
+    set_max_idle(size_t max_idle);
+
+    size_t
+    count_idle()
+      const;
+
+    explicit operator
+    bool()
+      const;
+
+    // Load a script. Idle instances are destroyed. Instances that are leased are
+    // destroyed when they are returned, and are not affected otherwise.
+    Script_Pool&
+    reload(const cow_string& name, int line, tinybuf& cbuf);
+
+    Script_Pool&
+    reload_string(const cow_string& name, const cow_string& code);
+
+    Script_Pool&
+    reload_string(const cow_string& name, int line, const cow_string& code);
+
+    Script_Pool&
+    reload_file(const char* path);
+
+    // Lease an instance, creating a new one if there are no idle ones. The
+    // instance is returned to the pool when the lease is destroyed.
+    Lease
+    acquire();
+  };
+
+class Script_Pool::Lease
+  {
+    friend Script_Pool;
+
+  private:
+    Script_Pool* m_pool = nullptr;
+    uptr<Instance> m_inst;
+
+  public:
+    Lease()
+      noexcept;
+
+  private:
+    explicit
+    Lease(Script_Pool* pool, uptr<Instance>&& inst)
+      noexcept;
+
+  public:
+    Lease(Lease&& other)
+      noexcept;
+
+    Lease&
+    operator=(Lease&& other)
+      noexcept;
+
+    ~Lease();
+
+  public:
+    explicit operator
+    bool()
+      const noexcept
+      { return bool(this->m_inst);  }
+
+    // These functions require an instance.
+    Global_Context&
+    global()
+      const;
+
+    const cow_function&
+    function()
+      const;
+
+    // Execute the script in this instance. The stack overflow protection is
+    // rebased to the calling thread.
+    Reference
+    execute(Reference_Stack&& stack)
+      const;
+
+    Reference
+    execute(cow_vector<Value>&& args = { })
+      const;
+
+    // Return the instance to the pool. If `discard` is `true`, the instance is
+    // destroyed instead, which may be desired if its global context has been
+    // modified.
+    Lease&
+    release(bool discard = false)
+      noexcept;
+  };
+
+}  // namespace asteria
+
+#endif
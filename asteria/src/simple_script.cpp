@@ -9,28 +9,131 @@
 #include "compiler/expression_unit.hpp"
 #include "runtime/air_optimizer.hpp"
 #include "llds/reference_stack.hpp"
+#include "library/checksum.hpp"
 #include "utils.hpp"
+#include <sys/stat.h>  // ::fstat(), ::fchmod()
+#include <sys/mman.h>  // ::mmap(), ::munmap()
 
 namespace asteria {
+namespace {
 
-Simple_Script&
-Simple_Script::
-reload(const cow_string& name, int line, tinybuf& cbuf)
+const cow_vector<phsh_string>&
+do_script_params(cow_vector<phsh_string>& params)
+  {
+    // A script is a variadic function.
+    if(ROCKET_UNEXPECT(params.empty()))
+      params.emplace_back(sref("..."));
+    return params;
+  }
+
+void
+do_compile(AIR_Optimizer& optmz, const cow_vector<phsh_string>& params,
+           const cow_string& name, int line, tinybuf& cbuf)
   {
     // Parse source code.
-    Token_Stream tstrm(this->m_opts);
+    Token_Stream tstrm(optmz.get_options());
     tstrm.reload(name, line, cbuf);
 
-    Statement_Sequence stmtq(this->m_opts);
+    Statement_Sequence stmtq(optmz.get_options());
     stmtq.reload(tstrm);
 
-    // Instantiate the function.
-    const Source_Location sloc(name, 0, 0);
-    if(ROCKET_UNEXPECT(this->m_params.empty()))
-      this->m_params.emplace_back(sref("..."));
+    // Generate code.
+    optmz.reload(nullptr, params, stmtq);
+  }
+
+cow_string
+do_make_cache_key(const Compiler_Options& opts, const cow_string& name, const cow_string& text)
+  {
+    // Everything that affects code generation goes into the key, including the
+    // version of this library, as the format of serialized code may change.
+    auto hasher = std_checksum_SHA256_private();
+    cow_string temp;
+    temp << PACKAGE_STRING << '\0';
+    temp.append(reinterpret_cast<const char*>(&opts), sizeof(opts));
+    temp << name << '\0';
+    std_checksum_SHA256_update(hasher, temp);
+    std_checksum_SHA256_update(hasher, text);
+    return std_checksum_SHA256_finish(hasher);
+  }
+
+opt<cow_vector<AIR_Node>>
+do_load_cache_opt(const cow_string& path, const cow_string& key)
+  {
+    // Errors are ignored. The script is compiled again if the cache file can't be
+    // loaded for any reason.
+    ::rocket::unique_posix_fd fd(::open(path.safe_c_str(), O_RDONLY), ::close);
+    if(!fd)
+      return nullopt;
+
+    // The file starts with the key, which is followed by the checksum of serialized
+    // code, both of which are SHA-256 strings. Then comes serialized code.
+    struct ::stat stb;
+    if((::fstat(fd, &stb) != 0) || (stb.st_size < key.ssize() * 2))
+      return nullopt;
+
+    size_t size = static_cast<size_t>(stb.st_size);
+    void* base = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(base == MAP_FAILED)
+      return nullopt;
+
+    opt<cow_vector<AIR_Node>> qcode;
+    const char* bptr = static_cast<const char*>(base);
+    size_t hlen = key.size() * 2;
+    if(::std::memcmp(bptr, key.data(), key.size()) == 0) {
+      try {
+        // Reject files that have been damaged or truncated.
+        auto sum = std_checksum_sha256(bptr + hlen, size - hlen);
+        if((sum.size() == key.size()) &&
+           (::std::memcmp(bptr + key.size(), sum.data(), sum.size()) == 0))
+          qcode = AIR_Node::deserialize_all(bptr + hlen, size - hlen);
+      }
+      catch(exception& stdex) {
+        // The file is corrupted.
+      }
+    }
+    ::munmap(base, size);
+    return qcode;
+  }
+
+void
+do_store_cache(const cow_string& path, const cow_string& key, const cow_vector<AIR_Node>& code)
+  {
+    cow_string payload;
+    if(!AIR_Node::serialize_all(payload, code))
+      return;
+
+    cow_string data = key;
+    data << std_checksum_sha256(payload) << payload;
+
+    // Write data into a temporary file, then move it into place, so other processes
+    // never see incomplete files. Errors are ignored.
+    cow_string tpath = path + ".XXXXXX";
+    ::rocket::unique_posix_fd fd(::mkstemp(tpath.mut_data()), ::close);
+    if(!fd)
+      return;
 
+    ::fchmod(fd, 0644);
+    size_t off = 0;
+    ::ssize_t nwritten;
+    while((off < data.size()) && ((nwritten = ::write(fd, data.data() + off, data.size() - off)) > 0))
+      off += static_cast<size_t>(nwritten);
+
+    fd.reset();
+    if((off != data.size()) || (::rename(tpath.c_str(), path.c_str()) != 0))
+      ::unlink(tpath.c_str());
+  }
+
+}  // namespace
+
+Simple_Script&
+Simple_Script::
+reload(const cow_string& name, int line, tinybuf& cbuf)
+  {
     AIR_Optimizer optmz(this->m_opts);
-    optmz.reload(nullptr, this->m_params, stmtq);
+    do_compile(optmz, do_script_params(this->m_params), name, line, cbuf);
+
+    // Instantiate the function.
+    const Source_Location sloc(name, 0, 0);
     this->m_func = optmz.create_function(sloc, sref("[file scope]"));
     return *this;
   }
@@ -82,7 +185,38 @@ reload_file(const char* path)
     // Open the file denoted by this path.
     ::rocket::tinybuf_file cbuf;
     cbuf.open(abspath, tinybuf::open_read);
-    return this->reload(cow_string(abspath), 1, cbuf);
+    if(this->m_cache_dir.empty())
+      return this->reload(cow_string(abspath), 1, cbuf);
+
+    // Read all source code, which is required to compose the cache key.
+    const cow_string name(abspath);
+    cow_string text;
+    char temp[4096];
+    size_t nread;
+    while((nread = cbuf.getn(temp, sizeof(temp))) != 0)
+      text.append(temp, nread);
+
+    auto key = do_make_cache_key(this->m_opts, name, text);
+    auto cpath = this->m_cache_dir + '/' + key + ".air";
+
+    // Load code from the cache. If this fails, compile the file and store the
+    // result for later use.
+    AIR_Optimizer optmz(this->m_opts);
+    auto qcode = do_load_cache_opt(cpath, key);
+    if(qcode) {
+      optmz.rebind(nullptr, do_script_params(this->m_params), *qcode);
+    }
+    else {
+      ::rocket::tinybuf_str sbuf;
+      sbuf.set_string(text, tinybuf::open_read);
+      do_compile(optmz, do_script_params(this->m_params), name, 1, sbuf);
+      do_store_cache(cpath, key, optmz);
+    }
+
+    // Instantiate the function.
+    const Source_Location sloc(name, 0, 0);
+    this->m_func = optmz.create_function(sloc, sref("[file scope]"));
+    return *this;
   }
 
 Reference
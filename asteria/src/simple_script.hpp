@@ -14,6 +14,7 @@ class Simple_Script
     Compiler_Options m_opts;  // static
     cow_vector<phsh_string> m_params;  // constant
     cow_function m_func;  // note type erasure
+    cow_string m_cache_dir;  // for `reload_file()`
 
   public:
     explicit constexpr
@@ -64,6 +65,19 @@ class Simple_Script
       noexcept
       { return this->m_opts = opts, *this;  }
 
+    // If a cache directory is set, code that has been compiled by `reload_file()`
+    // is stored there, and is reused when the same file is loaded again with the
+    // same options, possibly by another process. The directory must exist.
+    const cow_string&
+    get_cache_directory()
+      const noexcept
+      { return this->m_cache_dir;  }
+
+    Simple_Script&
+    set_cache_directory(const cow_string& dir)
+      noexcept
+      { return this->m_cache_dir = dir, *this;  }
+
     explicit operator
     bool()
       const noexcept
@@ -410,6 +410,22 @@ utf16_decode(char32_t& cp, const cow_u16string& text, size_t& offset)
     return true;
   }
 
+cow_string
+format_function_signature(const cow_string& name, const cow_vector<phsh_string>& params)
+  {
+    cow_string func = name;
+    if(is_cctype(name.front(), cctype_namei) && (name.back() != ')')) {
+      func << '(';
+      if(params.size()) {
+        func << params[0];
+        for(size_t k = 1;  k != params.size();  ++k)
+          func << ", " << params[k];
+      }
+      func << ')';
+    }
+    return func;
+  }
+
 Wrapped_Index
 wrap_index(int64_t index, size_t size)
   noexcept
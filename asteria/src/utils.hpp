@@ -167,6 +167,12 @@ format_errno(int err)
   noexcept
   { return { err };  }
 
+// Function signatures
+// If `name` looks like a function name, parameters are appended in parentheses.
+// Otherwise, it is returned intact.
+cow_string
+format_function_signature(const cow_string& name, const cow_vector<phsh_string>& params);
+
 // Negative array index wrapper
 struct Wrapped_Index
   {
@@ -0,0 +1,205 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../src/simple_script.hpp"
+#include "../src/runtime/global_context.hpp"
+#include "../src/runtime/reference.hpp"
+#include "../src/runtime/air_node.hpp"
+#include "../src/llds/avmc_queue.hpp"
+#include "../src/value.hpp"
+#include <dirent.h>  // ::opendir()
+
+using namespace asteria;
+
+namespace {
+
+size_t
+do_count_cache_files(const char* dir)
+  {
+    ::rocket::unique_posix_dir dp(::opendir(dir), ::closedir);
+    ROCKET_ASSERT(dp);
+    size_t count = 0;
+    while(auto entry = ::readdir(dp))
+      count += ::strstr(entry->d_name, ".air") != nullptr;
+    return count;
+  }
+
+cow_string
+do_read_cache_file(const char* dir)
+  {
+    ::rocket::unique_posix_dir dp(::opendir(dir), ::closedir);
+    ROCKET_ASSERT(dp);
+    while(auto entry = ::readdir(dp))
+      if(::strstr(entry->d_name, ".air")) {
+        ::rocket::unique_posix_file fp(::fopen((cow_string(dir) + '/' + entry->d_name).c_str(), "rb"), ::fclose);
+        ROCKET_ASSERT(fp);
+        cow_string data;
+        int ch;
+        while((ch = ::fgetc(fp)) != EOF)
+          data.push_back(static_cast<char>(ch));
+        return data;
+      }
+    return sref("");
+  }
+
+void
+do_flip_cache_files(const char* dir, size_t off)
+  {
+    ::rocket::unique_posix_dir dp(::opendir(dir), ::closedir);
+    ROCKET_ASSERT(dp);
+    while(auto entry = ::readdir(dp))
+      if(::strstr(entry->d_name, ".air")) {
+        ::rocket::unique_posix_file fp(::fopen((cow_string(dir) + '/' + entry->d_name).c_str(), "r+b"), ::fclose);
+        ROCKET_ASSERT(fp);
+        ::fseek(fp, static_cast<long>(off), SEEK_SET);
+        int ch = ::fgetc(fp);
+        ::fseek(fp, static_cast<long>(off), SEEK_SET);
+        ::fputc(ch ^ 0x5A, fp);
+      }
+  }
+
+cow_string
+do_load_and_execute(Simple_Script& code, const char* path)
+  {
+    Global_Context global;
+    code.reload_file(path);
+    return code.execute(global).dereference_readonly().as_string();
+  }
+
+}  // namespace
+
+int main()
+  {
+    char dir[] = "/tmp/asteria-air_cache-XXXXXX";
+    ROCKET_ASSERT(::mkdtemp(dir));
+    auto path = cow_string(dir) + "/script.txt";
+
+    // This script covers as many kinds of nodes as possible.
+    ::rocket::unique_posix_file fp(::fopen(path.c_str(), "w"), ::fclose);
+    ROCKET_ASSERT(fp);
+    ::fputs(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        const table = { one: 1, two: 2.5, three: "three", four: [ true, null ] };
+        var out = [];
+
+        func add(x, y) { return x + y;  }
+        func sum(...) {
+          var s = 0;
+          for(var i = 0;  i < __varg();  ++i)
+            s += __varg(i);
+          return s;
+        }
+        out[$] = add(1, 2);
+        out[$] = sum(1, 2, 3, 4);
+
+        var k = 0;
+        while(k < 5)
+          ++k;
+        do
+          --k;
+        while(k > 2);
+        out[$] = k;
+
+        for(each key, value -> table)
+          out[$] = countof key;
+
+        switch(k) {
+          case 1:
+            out[$] = "one";
+          case 2:
+            out[$] = "two";
+            break;
+          default:
+            out[$] = "other";
+        }
+
+        var [ a, b ] = [ 10, 20 ];
+        var { one, three } = table;
+        out[$] = a + b;
+        out[$] = three;
+        out[$] = table.four[1] ?? "null";
+        out[$] = k > 1 ? "big" : "small";
+
+        var log = [];
+        func logged() { defer log[$] = "deferred";  return "body";  }
+        out[$] = logged();
+        out[$] = log[0];
+
+        func fail() { throw "meow";  }
+        try
+          fail();
+        catch(e) {
+          out[$] = e;
+          assert std.string.find(__backtrace[0].file, "script.txt") != null;
+        }
+
+        ref r -> out[0];
+        r += 100;
+        assert countof out == 15;
+        return std.json.format(out);
+
+///////////////////////////////////////////////////////////////////////////////
+)__", fp);
+    fp.reset();
+
+    // Get the result without the cache.
+    Simple_Script code;
+    auto result = do_load_and_execute(code, path.c_str());
+    ASTERIA_TEST_CHECK(do_count_cache_files(dir) == 0);
+
+    // Compile the script and store it into the cache.
+    code.set_cache_directory(cow_string(dir));
+    ASTERIA_TEST_CHECK(do_load_and_execute(code, path.c_str()) == result);
+    ASTERIA_TEST_CHECK(do_count_cache_files(dir) == 1);
+
+    // Load the script from the cache.
+    ASTERIA_TEST_CHECK(do_load_and_execute(code, path.c_str()) == result);
+    ASTERIA_TEST_CHECK(do_count_cache_files(dir) == 1);
+
+    // Flipped bits in serialized code shall either be rejected, or result in valid
+    // code, even if the checksum is bypassed. The header consists of two SHA-256
+    // strings.
+    auto data = do_read_cache_file(dir);
+    ASTERIA_TEST_CHECK(data.size() > 128);
+    for(size_t off = 128;  off != data.size();  ++off)
+      for(unsigned mask = 1;  mask <= 0x80;  mask <<= 1) {
+        auto temp = data.substr(128);
+        temp.mut(off - 128) = static_cast<char>(temp[off - 128] ^ static_cast<char>(mask));
+        try {
+          // Code that has been loaded must be valid for solidification.
+          AVMC_Queue queue;
+          AIR_Node::solidify_all(queue, AIR_Node::deserialize_all(temp.data(), temp.size()));
+        }
+        catch(exception& stdex) {
+          // This is expected, but not guaranteed for all bytes.
+        }
+      }
+
+    // The checksum catches flipped bytes, so the script is compiled again and the
+    // cache file is replaced.
+    do_flip_cache_files(dir, data.size() / 2);
+    ASTERIA_TEST_CHECK(do_load_and_execute(code, path.c_str()) == result);
+    ASTERIA_TEST_CHECK(do_read_cache_file(dir) == data);
+
+    // Different options make a different key.
+    code.open_options().optimization_level = 3;
+    ASTERIA_TEST_CHECK(do_load_and_execute(code, path.c_str()) == result);
+    ASTERIA_TEST_CHECK(do_count_cache_files(dir) == 2);
+
+    // Corrupted files are ignored.
+    ::rocket::unique_posix_dir dp(::opendir(dir), ::closedir);
+    while(auto entry = ::readdir(dp))
+      if(::strstr(entry->d_name, ".air"))
+        ::truncate((cow_string(dir) + '/' + entry->d_name).c_str(), 100);
+    dp.reset();
+    ASTERIA_TEST_CHECK(do_load_and_execute(code, path.c_str()) == result);
+
+    // Clean up.
+    dp.reset(::opendir(dir));
+    while(auto entry = ::readdir(dp))
+      if(entry->d_name[0] != '.')
+        ::unlink((cow_string(dir) + '/' + entry->d_name).c_str());
+    ::rmdir(dir);
+  }
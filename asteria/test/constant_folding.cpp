@@ -0,0 +1,174 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../src/simple_script.hpp"
+#include "../src/runtime/global_context.hpp"
+#include "../src/runtime/air_optimizer.hpp"
+#include "../src/runtime/air_node.hpp"
+#include "../src/compiler/token_stream.hpp"
+#include "../src/compiler/statement_sequence.hpp"
+
+using namespace asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        // Operators on constants.
+        assert 1 + 2 * 3 == 7;
+        assert (1 + 2) * 3 == 9;
+        assert 7 / 2 == 3;
+        assert 7 % -3 == 1;
+        assert 1.5 + 1 == 2.5;
+        assert 7.5 % 2 == 1.5;
+        assert -(1 + 1) == -2;
+        assert ~0 == -1;
+        assert !(1 < 2) == false;
+        assert (6 & 3 | 8 ^ 1) == 11;
+        assert (true + false) == true;
+        assert "ab" + "cd" == "abcd";
+        assert "abc" < "abd";
+        assert (nan == nan) == false;
+        assert (nan != nan) == true;
+
+        // Operations that fail are evaluated at runtime.
+        try {
+          var r = 0x7FFFFFFFFFFFFFFF + 1;
+          assert false;
+        }
+        catch(e)
+          assert std.string.find(e, "Integer addition overflow") != null;
+        try {
+          var r = 1 / 0;
+          assert false;
+        }
+        catch(e)
+          assert std.string.find(e, "Integer division by zero") != null;
+        try {
+          var r = nan < 1.0;
+          assert false;
+        }
+        catch(e)
+          assert std.string.find(e, "Values not comparable") != null;
+        try {
+          var r = "a" - "b";
+          assert false;
+        }
+        catch(e)
+          assert std.string.find(e, "Infix subtraction not applicable") != null;
+
+        // Immutable variables.
+        const seconds = 60;
+        const minutes = seconds * 60;
+        const name = "conf" + "ig";
+        assert minutes == 3600;
+        assert name == "config";
+        {
+          const seconds = 1;
+          assert seconds == 1;
+          assert minutes * seconds == 3600;
+        }
+        assert seconds == 60;
+
+        func hours(n) { return n * minutes;  }
+        assert hours(2) == 7200;
+
+        // Immutable variables can still be referenced and are reported as such.
+        ref r -> minutes;
+        assert r == 3600;
+        try {
+          minutes = 1;
+          assert false;
+        }
+        catch(e)
+          assert std.string.find(e, "Attempt to modify an immutable variable") != null;
+        try {
+          r = 1;
+          assert false;
+        }
+        catch(e)
+          assert std.string.find(e, "Attempt to modify an immutable variable") != null;
+        try {
+          ++minutes;
+          assert false;
+        }
+        catch(e)
+          assert std.string.find(e, "Attempt to modify an immutable variable") != null;
+
+        // Redeclarations hide previous values.
+        var k = 1;
+        const k = 2;
+        assert k == 2;
+        var k = 3;
+        assert k == 3;
+        k = 4;
+        assert k == 4;
+
+        // Declarations in bypassed clauses must not be propagated.
+        switch(2) {
+          case 1:
+            const w = 5;
+          case 2:
+            try {
+              std.debug.logf("$1", w);
+              assert false;
+            }
+            catch(e)
+              assert std.string.find(e, "bypassed") != null;
+        }
+
+        // Branches with constant conditions.
+        var out = [];
+        if(minutes > 60)
+          out[$] = "yes";
+        else
+          out[$] = "no";
+        if(seconds < 0)
+          out[$] = "negative";
+        assert out == [ "yes" ];
+        assert (1 < 2 ? "a" : "b") == "a";
+        assert (1 > 2 ? "a" : "b") == "b";
+        assert (true && "x") == "x";
+        assert (false && "x") == false;
+        assert (0 || "y") == "y";
+        assert (1 || "y") == 1;
+        assert (null ?? "z") == "z";
+        assert (0 ?? "z") == 0;
+
+        // Equal strings.
+        var s1 = "hello world";
+        var s2 = "hello world";
+        assert s1 == s2;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    Global_Context global;
+    code.execute(global);
+
+    // Values of immutable variables are propagated into operators and branches.
+    ::rocket::tinybuf_str cbuf;
+    cbuf.set_string(sref(R"__(
+        const a = 6;
+        const b = a * 7;
+        if(b == 42)
+          return "x";
+        return "y";
+      )__"), tinybuf::open_read);
+    Compiler_Options opts;
+    Token_Stream tstrm(opts);
+    tstrm.reload(sref(__FILE__), __LINE__, cbuf);
+    Statement_Sequence stmtq(opts);
+    stmtq.reload(tstrm);
+    AIR_Optimizer optmz(opts);
+    optmz.reload(nullptr, { sref("...") }, stmtq);
+
+    const cow_vector<AIR_Node>& nodes = optmz;
+    for(const auto& node : nodes) {
+      ASTERIA_TEST_CHECK(node.index() != AIR_Node::index_apply_operator);
+      ASTERIA_TEST_CHECK(node.index() != AIR_Node::index_if_statement);
+    }
+  }
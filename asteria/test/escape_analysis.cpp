@@ -0,0 +1,132 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../src/simple_script.hpp"
+#include "../src/runtime/global_context.hpp"
+#include "../src/runtime/genius_collector.hpp"
+
+using namespace asteria;
+
+namespace {
+
+size_t
+do_count_tracked(Global_Context& global)
+  {
+    const auto gcoll = global.genius_collector();
+    return gcoll->open_collector(gc_generation_newest).count_tracked_variables() +
+           gcoll->open_collector(gc_generation_middle).count_tracked_variables() +
+           gcoll->open_collector(gc_generation_oldest).count_tracked_variables();
+  }
+
+}  // namespace
+
+int main()
+  {
+    // Check that results are not affected.
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func sum(n) {
+          var s = 0;
+          for(var i = 0;  i < n;  ++i) {
+            var t = [ i, i * 2 ];
+            s += t[1] - t[0];
+          }
+          return s;
+        }
+        assert sum(10) == 45;
+
+        func counter() {
+          var c = 0;
+          return func() { return ++c;  };
+        }
+        var next = counter();
+        assert next() == 1;
+        assert next() == 2;
+
+        func bump(x) {
+          ++x;
+        }
+        func pass() {
+          var v = 5;
+          bump(ref v);
+          return v;
+        }
+        assert pass() == 6;
+
+        func alias() {
+          var a = 1;
+          ref b -> a;
+          b = 7;
+          return a;
+        }
+        assert alias() == 7;
+
+        func elem() {
+          var o = { x: [ 1, 2 ] };
+          ref r -> o.x[1];
+          r = 42;
+          return o.x[1];
+        }
+        assert elem() == 42;
+
+        func pick(k) {
+          var a = 1, b = 2;
+          return ref k ? a : b;
+        }
+        assert pick(true) == 1;
+        assert pick(false) == 2;
+
+        func cycle() {
+          var f;
+          f = func() { return f;  };
+          return f;
+        }
+        assert typeof cycle()() == "function";
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    Global_Context global;
+    code.execute(global);
+
+    // Local variables that don't escape are not tracked.
+    size_t base = do_count_tracked(global);
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func local() {
+          var a = 1, b = [ a, 2 ];
+          for(var i = 0;  i < 3;  ++i)
+            b[i] = a + i;
+          return b;
+        }
+        local();
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    code.execute(global);
+    ASTERIA_TEST_CHECK(do_count_tracked(global) == base + 1);  // `local`
+
+    // Variables that are captured or passed by reference are tracked.
+    base = do_count_tracked(global);
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func capture() {
+          var a = 1, b = 2;
+          var f = func() { return a;  };
+          std.array.sort([ b ]);
+          return f();
+        }
+        capture();
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    code.execute(global);
+    ASTERIA_TEST_CHECK(do_count_tracked(global) == base + 3);  // `capture`, `a`, `f`
+  }
@@ -0,0 +1,77 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../src/simple_script.hpp"
+#include "../src/runtime/global_context.hpp"
+
+using namespace asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        // Bodies that only read elements.
+        var a = [ 1, 2, 3, 4 ];
+        var s = 0;
+        for(each k, v -> a)
+          s += v * k;
+        assert s == 20;
+
+        var o = { x: 1, y: 2, z: 3 };
+        var t = 0;
+        for(each k, v -> o)
+          if(v)
+            t += v;
+        assert t == 6;
+
+        var r = [];
+        for(each k, v -> [ "a", "b", "c" ]) {
+          if(k == 1)
+            continue;
+          r[$] = v;
+        }
+        assert r == [ "a", "c" ];
+
+        r = [];
+        for(each i, x -> a)
+          for(each j, y -> a) {
+            if(j > i)
+              break;
+            r[$] = x - y;
+          }
+        assert r == [ 0, 1, 0, 2, 1, 0, 3, 2, 1, 0 ];
+
+        // The range is a copy, which is not affected by changes to the original.
+        r = [];
+        for(each k, v -> a) {
+          if(k + 1 < countof a)
+            a[k+1] = 0;
+          r[$] = v;
+        }
+        assert r == [ 1, 2, 3, 4 ];
+        assert a == [ 1, 0, 0, 0 ];
+
+        // Elements are not writable.
+        try {
+          for(each k, v -> a)
+            v *= 2;
+          assert false;
+        }
+        catch(e)
+          assert std.string.find(e, "Attempt to modify a temporary") != null;
+
+        // Elements outlast their iterations.
+        r = [];
+        for(each k, v -> o)
+          r[$] = func() { return v;  };
+        assert r[0]() + r[1]() + r[2]() == 6;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    Global_Context global;
+    code.execute(global);
+  }
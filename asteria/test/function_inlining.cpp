@@ -0,0 +1,87 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../src/simple_script.hpp"
+#include "../src/runtime/global_context.hpp"
+
+using namespace asteria;
+
+int main()
+  {
+    Compiler_Options opts;
+    opts.optimization_level = 3;
+    Simple_Script code(opts);
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func square(x) { return x * x;  }
+        func clamp(x, lo, hi) { return x < lo ? lo : x > hi ? hi : x;  }
+        func nothing() { }
+        func name() { return __func;  }
+
+        // Results, including references and void, must be preserved.
+        var s = 0;
+        for(var i = 0;  i < 10;  ++i)
+          s += square(i);
+        assert s == 285;
+        assert clamp(-5, 0, 10) == 0;
+        assert clamp(15, 0, 10) == 10;
+        assert clamp(square(2), 0, 10) == 4;
+        nothing();
+        assert name() == "name()";
+
+        // Missing arguments are null, and excess ones are errors.
+        func second(x, y) { return y;  }
+        assert second(3) == null;
+        try {
+          square(3, 4, 5);
+          assert false;
+        }
+        catch(e)
+          assert std.string.find(e, "Too many arguments") != null;
+
+        // Calls in tail positions.
+        func outer(x) { return square(x + 1);  }
+        assert outer(2) == 9;
+        func outer_ref(x) { return ref square(x);  }
+        assert outer_ref(3) == 9;
+
+        // Deferred expressions are executed when the inlined body exits.
+        var log = [];
+        func logged(x) { defer log[$] = x;  return x * 2;  }
+        assert logged(5) == 10;
+        assert log == [5];
+
+        // Exceptions are propagated with backtraces.
+        func fail(x) { throw x;  }
+        try {
+          fail("meow");
+          assert false;
+        }
+        catch(e) {
+          assert e == "meow";
+          var found = false;
+          for(each k, v -> __backtrace)
+            found ||= (std.string.find(v.frame, "function") != null) && (v.value == "fail(x)");
+          assert found;
+        }
+
+        // Functions that capture outer variables are not inlined, but still work.
+        var k = 3;
+        func scale(x) { return x * k;  }
+        k = 4;
+        assert scale(2) == 8;
+
+        // Recursive and variadic functions are not inlined either.
+        func fact(n) { return n <= 1 ? 1 : n * fact(n - 1);  }
+        assert fact(5) == 120;
+        func count(...) { return __varg();  }
+        assert count(1, 2, 3) == 3;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    Global_Context global;
+    code.execute(global);
+  }
@@ -40,6 +40,13 @@ int main()
     // Ignore leaks of emutls, emergency pool, etc.
     delete new int;
 
+    // Ignore the standard library, which is shared by all global contexts.
+    {
+      Global_Context global;
+    }
+
+    // Variables are allocated from pages, so they are counted separately.
+    size_t nvars = Variable::count_allocated();
     rcptr<Variable> var;
     bcnt.store(0, ::std::memory_order_relaxed);
     {
@@ -75,5 +82,6 @@ int main()
     }
     ASTERIA_TEST_CHECK(var->is_initialized() == false);
     var.reset();
+    ASTERIA_TEST_CHECK(Variable::count_allocated() == nvars);
     ASTERIA_TEST_CHECK(bcnt.load(::std::memory_order_relaxed) == 0);
   }
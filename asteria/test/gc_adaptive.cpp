@@ -0,0 +1,99 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../src/simple_script.hpp"
+#include "../src/runtime/global_context.hpp"
+#include "../src/runtime/genius_collector.hpp"
+
+using namespace asteria;
+
+namespace {
+
+void
+do_leak(Global_Context& global)
+  {
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func leak() {
+          var f;
+          f = func() { return f; };
+        }
+        for(var i = 0;  i < 20000;  ++i)
+          leak();
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    code.execute(global);
+  }
+
+void
+do_keep(Global_Context& global)
+  {
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func make(i) {
+          var x = i;
+          return func() { return x; };
+        }
+        var keep = [];
+        for(var i = 0;  i < 20000;  ++i)
+          keep[$] = make(i);
+        return keep;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    code.execute(global);
+  }
+
+}  // namespace
+
+int main()
+  {
+    // Thresholds are adaptive by default.
+    {
+      Global_Context global;
+      const auto& newest = global.genius_collector()->get_collector(gc_generation_newest);
+      ASTERIA_TEST_CHECK(newest.is_threshold_adaptive());
+      ASTERIA_TEST_CHECK(newest.get_threshold() == 800);
+
+      // Most variables are garbage, so the threshold is lowered to its minimum.
+      do_leak(global);
+      ASTERIA_TEST_CHECK(newest.get_threshold() == newest.get_threshold_min());
+    }
+
+    {
+      Global_Context global;
+      const auto& newest = global.genius_collector()->get_collector(gc_generation_newest);
+
+      // Most variables survive, so the threshold is raised.
+      do_keep(global);
+      ASTERIA_TEST_CHECK(newest.get_threshold() > 800);
+      ASTERIA_TEST_CHECK(newest.get_threshold() <= newest.get_threshold_max());
+    }
+
+    // Setting a threshold explicitly disables adaptation.
+    {
+      Global_Context global;
+      auto& newest = global.genius_collector()->open_collector(gc_generation_newest);
+      newest.set_threshold(800);
+      ASTERIA_TEST_CHECK(!newest.is_threshold_adaptive());
+
+      do_leak(global);
+      ASTERIA_TEST_CHECK(newest.get_threshold() == 800);
+
+      // Enabling it again clamps the threshold.
+      newest.set_threshold_bounds(1000, 2000);
+      ASTERIA_TEST_CHECK(newest.is_threshold_adaptive());
+      ASTERIA_TEST_CHECK(newest.get_threshold() == 1000);
+
+      newest.set_threshold_bounds(5, 5);
+      ASTERIA_TEST_CHECK(!newest.is_threshold_adaptive());
+    }
+  }
@@ -0,0 +1,51 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../src/simple_script.hpp"
+#include "../src/runtime/global_context.hpp"
+#include "../src/runtime/genius_collector.hpp"
+
+using namespace asteria;
+
+namespace {
+
+size_t
+do_count_tracked(Global_Context& global)
+  {
+    const auto gcoll = global.genius_collector();
+    return gcoll->get_collector(gc_generation_newest).count_tracked_variables() +
+           gcoll->get_collector(gc_generation_middle).count_tracked_variables() +
+           gcoll->get_collector(gc_generation_oldest).count_tracked_variables();
+  }
+
+}  // namespace
+
+int main()
+  {
+    Global_Context global;
+    size_t base = do_count_tracked(global);
+
+    // Each call leaves a cycle of two variables, each of which is captured by
+    // the function in the other.
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func leak() {
+          var a, b;
+          a = func() { return b; };
+          b = func() { return a; };
+        }
+        for(var i = 0;  i < 100;  ++i)
+          leak();
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    code.execute(global);
+
+    // All cycles are collected, and none are promoted to older generations.
+    global.genius_collector()->collect_variables();
+    ASTERIA_TEST_CHECK(do_count_tracked(global) < base + 10);
+  }
@@ -0,0 +1,157 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../src/simple_script.hpp"
+#include "../src/runtime/global_context.hpp"
+#include "../src/runtime/genius_collector.hpp"
+#include "../src/runtime/variable.hpp"
+
+using namespace asteria;
+
+int main()
+  {
+    Global_Context global;
+    auto gcoll = global.genius_collector();
+    auto& newest = gcoll->open_collector(gc_generation_newest);
+    newest.set_threshold(UINT32_MAX);
+
+    auto var = gcoll->create_variable(gc_generation_oldest);
+    var->initialize(V_null(), false);
+    Reference::S_variable xref = { var };
+    global.open_named_reference(sref("keep")) = ::std::move(xref);
+
+    // Create a lot of cycles, and a live one.
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func leak() {
+          var f;
+          f = func() { return f; };
+        }
+        for(var i = 0;  i < 1000;  ++i)
+          leak();
+
+        var x = [ 1, 2, 3 ];
+        var f;
+        f = func() { return f ? x : null; };
+        keep = func() { return f(); };
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    code.execute(global);
+    size_t ntracked = newest.count_tracked_variables();
+    ASTERIA_TEST_CHECK(ntracked >= 1000);
+
+    // Collect them in slices.
+    newest.set_slice_size(100);
+    size_t nslices = 0;
+    do {
+      newest.collect_slice_opt();
+      nslices++;
+      ASTERIA_TEST_CHECK(newest.count_tracked_variables() <= ntracked);
+      ntracked = newest.count_tracked_variables();
+    }
+    while(newest.is_pass_in_progress());
+    ASTERIA_TEST_CHECK(nslices >= 5);
+    ASTERIA_TEST_CHECK(newest.count_tracked_variables() < 10);
+
+    code.reload_string(sref(__FILE__), __LINE__, sref("return keep()[2];"));
+    ASTERIA_TEST_CHECK(code.execute(global).dereference_readonly().as_integer() == 3);
+
+    // Collect cycles automatically, with slices of older generations interleaved
+    // with execution.
+    newest.set_threshold(100);
+    newest.set_slice_size(0);
+    gcoll->open_collector(gc_generation_middle).set_slice_size(100);
+    gcoll->open_collector(gc_generation_oldest).set_slice_size(100);
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func leak() {
+          var f;
+          f = func() { return f; };
+        }
+        for(var i = 0;  i < 100000;  ++i)
+          leak();
+        return keep()[1];
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    ASTERIA_TEST_CHECK(code.execute(global).dereference_readonly().as_integer() == 2);
+    ASTERIA_TEST_CHECK(newest.count_tracked_variables() <= 300);
+    ASTERIA_TEST_CHECK(gcoll->get_collector(gc_generation_middle).count_tracked_variables() <= 1000);
+    ASTERIA_TEST_CHECK(gcoll->get_collector(gc_generation_oldest).count_tracked_variables() <= 1000);
+
+    // The slice size limits variables that are processed by each slice, even if
+    // they are connected. Only the last slice of a pass processes more, which are
+    // those that it collects.
+    Global_Context other;
+    auto& ring = other.genius_collector()->open_collector(gc_generation_newest);
+    auto& older = other.genius_collector()->open_collector(gc_generation_middle);
+    ring.set_threshold(UINT32_MAX);
+    older.set_threshold(UINT32_MAX);
+    var = other.genius_collector()->create_variable(gc_generation_oldest);
+    var->initialize(V_null(), false);
+    xref = { var };
+    other.open_named_reference(sref("keep")) = ::std::move(xref);
+
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func ring() {
+          var first;
+          var next = func() { return first; };
+          for(var i = 0;  i < 1000;  ++i) {
+            var prev = next;
+            next = func() { return prev; };
+          }
+          first = next;
+          next = null;
+          return func() { return first; };
+        }
+        keep = ring();
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    code.execute(other);
+    ASTERIA_TEST_CHECK(ring.count_tracked_variables() >= 1000);
+
+    // The ring is alive, so it is transferred to the next generation.
+    ring.set_slice_size(10);
+    ring.clear_stats();
+    nslices = 0;
+    do {
+      auto stats = ring.get_stats();
+      ring.collect_slice_opt();
+      nslices++;
+      ASTERIA_TEST_CHECK(ring.get_stats().scanned - stats.scanned <=
+                         10 + ring.get_stats().collected - stats.collected);
+    }
+    while(ring.is_pass_in_progress());
+    ASTERIA_TEST_CHECK(nslices >= 300);
+    ASTERIA_TEST_CHECK(ring.get_stats().promoted >= 1000);
+    ASTERIA_TEST_CHECK(older.count_tracked_variables() >= 1000);
+
+    // Drop the ring, and collect it in slices.
+    code.reload_string(sref(__FILE__), __LINE__, sref("keep = null;"));
+    code.execute(other);
+    older.set_slice_size(10);
+    older.clear_stats();
+    nslices = 0;
+    do {
+      auto stats = older.get_stats();
+      older.collect_slice_opt();
+      nslices++;
+      ASTERIA_TEST_CHECK(older.get_stats().scanned - stats.scanned <=
+                         10 + older.get_stats().collected - stats.collected);
+    }
+    while(older.is_pass_in_progress());
+    ASTERIA_TEST_CHECK(nslices >= 300);
+    ASTERIA_TEST_CHECK(older.get_stats().collected >= 1000);
+    ASTERIA_TEST_CHECK(older.count_tracked_variables() < 10);
+  }
@@ -0,0 +1,99 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../src/simple_script.hpp"
+#include "../src/runtime/global_context.hpp"
+#include "../src/runtime/genius_collector.hpp"
+#include "../src/runtime/variable.hpp"
+
+using namespace asteria;
+
+namespace {
+
+size_t
+do_count_tracked(Global_Context& global)
+  {
+    const auto gcoll = global.genius_collector();
+    return gcoll->get_collector(gc_generation_newest).count_tracked_variables() +
+           gcoll->get_collector(gc_generation_middle).count_tracked_variables() +
+           gcoll->get_collector(gc_generation_oldest).count_tracked_variables();
+  }
+
+size_t
+do_count_lazy(Global_Context& global)
+  {
+    const auto gcoll = global.genius_collector();
+    return gcoll->get_collector(gc_generation_newest).count_lazy_variables() +
+           gcoll->get_collector(gc_generation_middle).count_lazy_variables() +
+           gcoll->get_collector(gc_generation_oldest).count_lazy_variables();
+  }
+
+}  // namespace
+
+int main()
+  {
+    Global_Context global;
+    auto gcoll = global.genius_collector();
+
+    // Variables are tracked lazily until they hold values that are not scalar.
+    size_t base = do_count_tracked(global);
+    size_t base_lazy = do_count_lazy(global);
+    auto var = gcoll->create_variable();
+    var->initialize(V_integer(42), false);
+    ASTERIA_TEST_CHECK(var->is_gc_lazy());
+    ASTERIA_TEST_CHECK(do_count_tracked(global) == base + 1);
+    ASTERIA_TEST_CHECK(do_count_lazy(global) == base_lazy + 1);
+
+    var->initialize(V_array(), false);
+    ASTERIA_TEST_CHECK(!var->is_gc_lazy());
+    ASTERIA_TEST_CHECK(do_count_tracked(global) == base + 1);
+    ASTERIA_TEST_CHECK(do_count_lazy(global) == base_lazy);
+
+    // Values that are stored in place are checked by the next collection.
+    auto var2 = gcoll->create_variable();
+    var2->initialize(V_string(sref("meow")), false);
+    var2->open_value() = V_null();
+    ASTERIA_TEST_CHECK(var2->is_gc_lazy());
+    var2->open_value() = V_array();
+    ASTERIA_TEST_CHECK(var2->is_gc_lazy());
+    gcoll->collect_variables();
+    ASTERIA_TEST_CHECK(!var2->is_gc_lazy());
+    ASTERIA_TEST_CHECK(var2->is_gc_tracked());
+    ASTERIA_TEST_CHECK(var2->get_value().is_array());
+    var.reset();
+    var2.reset();
+
+    // Captured variables that hold scalar values are not staged. Cycles that are
+    // formed by assignments to lazy variables are still collected.
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func make(i) {
+          var x = i;
+          return func() { return x; };
+        }
+        func leak() {
+          var a, b;
+          a = func() { return b; };
+          b = func() { return a; };
+        }
+        var r = 0;
+        for(var i = 0;  i < 1000;  ++i) {
+          r += make(i)();
+          leak();
+        }
+        return r;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    ASTERIA_TEST_CHECK(code.execute(global).dereference_readonly().as_integer() == 499500);
+
+    gcoll->collect_variables();
+    ASTERIA_TEST_CHECK(do_count_tracked(global) < base + 10);
+    ASTERIA_TEST_CHECK(gcoll->get_collector(gc_generation_newest).get_stats().collected +
+                       gcoll->get_collector(gc_generation_middle).get_stats().collected +
+                       gcoll->get_collector(gc_generation_oldest).get_stats().collected >= 2000);
+  }
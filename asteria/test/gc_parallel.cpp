@@ -0,0 +1,97 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../src/simple_script.hpp"
+#include "../src/runtime/global_context.hpp"
+#include "../src/runtime/genius_collector.hpp"
+#include "../src/runtime/variable.hpp"
+#include <dirent.h>  // ::opendir()
+
+using namespace asteria;
+
+namespace {
+
+size_t
+do_count_threads()
+  {
+    ::rocket::unique_posix_dir dp(::opendir("/proc/self/task"), ::closedir);
+    ASTERIA_TEST_CHECK(dp);
+
+    size_t count = 0;
+    while(auto ent = ::readdir(dp))
+      count += ent->d_name[0] != '.';
+    return count;
+  }
+
+size_t
+do_collect(uint32_t nworkers)
+  {
+    Global_Context global;
+    auto gcoll = global.genius_collector();
+    auto& newest = gcoll->open_collector(gc_generation_newest);
+    newest.set_threshold(UINT32_MAX);
+    newest.set_worker_count(nworkers);
+
+    auto var = gcoll->create_variable();
+    var->initialize(V_null(), false);
+    Reference::S_variable xref = { var };
+    global.open_named_reference(sref("keep")) = ::std::move(xref);
+
+    // Create a lot of cycles, half of which are kept alive. Cycles are kept via
+    // distinct closures, as function values are not tracked by collectors.
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func leak() {
+          var a, b;
+          a = func() { return b; };
+          b = func() { return a; };
+          return func() { return a; };
+        }
+        keep = [];
+        for(var i = 0;  i < 20000;  ++i) {
+          leak();
+          keep[$] = leak();
+        }
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    code.execute(global);
+    ASTERIA_TEST_CHECK(newest.count_tracked_variables() > 80000);
+
+    newest.collect_single_opt();
+    size_t count = newest.count_tracked_variables() +
+                   gcoll->get_collector(gc_generation_middle).count_tracked_variables();
+
+    code.reload_string(sref(__FILE__), __LINE__, sref(R"__(
+      var r = 0;
+      for(each k, f -> keep)
+        r += (typeof f()()() == "function") ? 0 : 1;
+      return r;
+    )__"));
+    ASTERIA_TEST_CHECK(code.execute(global).dereference_readonly().as_integer() == 0);
+    return count;
+  }
+
+}  // namespace
+
+int main()
+  {
+    size_t nbase = do_count_threads();
+
+    // Results shall be the same with and without parallel collection.
+    size_t count = do_collect(1);
+    ASTERIA_TEST_CHECK(count >= 40000);
+    ASTERIA_TEST_CHECK(count < 40100);
+    ASTERIA_TEST_CHECK(do_collect(4) == count);
+
+    // Worker threads are reused by later collections.
+    size_t nthreads = do_count_threads();
+    ASTERIA_TEST_CHECK(nthreads <= nbase + 3);
+    ASTERIA_TEST_CHECK(do_collect(4) == count);
+    ASTERIA_TEST_CHECK(do_collect(3) == count);
+    ASTERIA_TEST_CHECK(do_count_threads() == nthreads);
+  }
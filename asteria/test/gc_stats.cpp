@@ -0,0 +1,55 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../src/simple_script.hpp"
+#include "../src/runtime/global_context.hpp"
+#include "../src/runtime/genius_collector.hpp"
+
+using namespace asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func leak() {
+          var f;
+          f = func() { return f; };
+        }
+        for(var i = 0;  i < 5000;  ++i)
+          leak();
+        std.system.gc_collect();
+
+        var stats = std.system.gc_stats();
+        assert countof stats == 3;
+
+        var n_free = 0;
+        for(each g, s -> stats) {
+          assert s.t_total >= s.t_max;
+          assert s.t_max >= 0;
+          n_free += s.n_free;
+        }
+        assert n_free >= 4900;
+
+        assert stats[0].n_coll > 0;
+        assert stats[0].n_scan >= stats[0].n_free;
+        assert stats[0].n_reuse > 0;
+        assert stats[2].n_coll > 0;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    Global_Context global;
+    code.execute(global);
+
+    auto gcoll = global.genius_collector();
+    const auto& stats = gcoll->get_collector(gc_generation_newest).get_stats();
+    ASTERIA_TEST_CHECK(stats.collections > 0);
+    ASTERIA_TEST_CHECK(stats.pause_total >= stats.pause_max);
+    ASTERIA_TEST_CHECK(stats.scanned >= stats.collected + stats.promoted);
+
+    gcoll->open_collector(gc_generation_newest).clear_stats();
+    ASTERIA_TEST_CHECK(stats.collections == 0);
+  }
@@ -0,0 +1,60 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../src/simple_script.hpp"
+#include "../src/runtime/global_context.hpp"
+#include "../src/runtime/genius_collector.hpp"
+#include "../src/runtime/variable.hpp"
+
+using namespace asteria;
+
+int main()
+  {
+    rcptr<Genius_Collector> gcoll;
+    rcptr<Variable> escaped;
+    {
+      Global_Context global;
+      gcoll = global.genius_collector();
+      escaped = gcoll->create_variable();
+      escaped->initialize(V_array(), false);
+
+      // Create a long chain of closures, and some cycles.
+      Simple_Script code;
+      code.reload_string(
+        sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+          func leak() {
+            var a, b;
+            a = func() { return b; };
+            b = func() { return a; };
+            return a;
+          }
+          var p = null;
+          for(var i = 0;  i < 10000;  ++i) {
+            const q = p;
+            p = func() { return q; };
+          }
+          var cycles = [];
+          for(var i = 0;  i < 1000;  ++i)
+            cycles[$] = leak();
+          return typeof p;
+
+///////////////////////////////////////////////////////////////////////////////
+        )__"));
+      ASTERIA_TEST_CHECK(code.execute(global).dereference_readonly().as_string() == "function");
+      ASTERIA_TEST_CHECK(gcoll->get_collector(gc_generation_newest).count_tracked_variables() +
+                         gcoll->get_collector(gc_generation_middle).count_tracked_variables() +
+                         gcoll->get_collector(gc_generation_oldest).count_tracked_variables() > 1000);
+    }
+
+    // All variables have been released in bulk. Those that have escaped are left
+    // uninitialized.
+    ASTERIA_TEST_CHECK(gcoll->get_pool_size() == 0);
+    ASTERIA_TEST_CHECK(gcoll->get_collector(gc_generation_newest).count_tracked_variables() == 0);
+    ASTERIA_TEST_CHECK(gcoll->get_collector(gc_generation_middle).count_tracked_variables() == 0);
+    ASTERIA_TEST_CHECK(gcoll->get_collector(gc_generation_oldest).count_tracked_variables() == 0);
+    ASTERIA_TEST_CHECK(!escaped->is_initialized());
+    ASTERIA_TEST_CHECK(!escaped->is_gc_tracked());
+  }
@@ -0,0 +1,75 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../src/simple_script.hpp"
+#include "../src/runtime/global_context.hpp"
+#include "../src/runtime/genius_collector.hpp"
+#include "../src/runtime/variable.hpp"
+
+using namespace asteria;
+
+int main()
+  {
+    Global_Context global;
+    auto gcoll = global.genius_collector();
+    auto& newest = gcoll->open_collector(gc_generation_newest);
+    newest.set_threshold(UINT32_MAX);
+
+    auto var = gcoll->create_variable(gc_generation_oldest);
+    var->initialize(V_null(), false);
+    Reference::S_variable xref = { var };
+    global.open_named_reference(sref("keep")) = ::std::move(xref);
+
+    // Create a large heap, and move it into the oldest generation.
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func make(i) {
+          var x = i;
+          return func() { return x; };
+        }
+        keep = [];
+        for(var i = 0;  i < 20000;  ++i)
+          keep[$] = make(i);
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    code.execute(global);
+    gcoll->collect_variables();
+    ASTERIA_TEST_CHECK(gcoll->get_collector(gc_generation_oldest).count_tracked_variables() >= 20000);
+
+    // Create some cycles, each of which references the old heap.
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func leak() {
+          var f;
+          f = func() { return f ? keep : null; };
+        }
+        for(var i = 0;  i < 100;  ++i)
+          leak();
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    code.execute(global);
+    ASTERIA_TEST_CHECK(newest.count_tracked_variables() >= 100);
+
+    // Collecting the newest generation doesn't scan the old heap.
+    newest.clear_stats();
+    newest.collect_single_opt();
+    ASTERIA_TEST_CHECK(newest.get_stats().collected >= 100);
+    ASTERIA_TEST_CHECK(newest.get_stats().scanned < 1000);
+
+    // The old heap is intact.
+    code.reload_string(sref(__FILE__), __LINE__, sref(R"__(
+      var r = 0;
+      for(each k, f -> keep)
+        r += f();
+      return r;
+    )__"));
+    ASTERIA_TEST_CHECK(code.execute(global).dereference_readonly().as_integer() == 199990000);
+  }
@@ -0,0 +1,66 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../src/simple_script.hpp"
+#include "../src/runtime/global_context.hpp"
+#include "../src/runtime/global_snapshot.hpp"
+#include "../src/runtime/genius_collector.hpp"
+#include "../src/runtime/variable.hpp"
+
+using namespace asteria;
+
+int main()
+  {
+    Global_Context global;
+    ASTERIA_TEST_CHECK_CATCH(global.reset_to_snapshot());
+
+    auto var = global.genius_collector()->create_variable();
+    var->initialize(V_null(), false);
+    Reference::S_variable xref = { var };
+    global.open_named_reference(sref("counter")) = ::std::move(xref);
+
+    // Load a prelude, which stores a closure into a global variable.
+    Simple_Script prelude;
+    prelude.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        var n = 0;
+        counter = func() { return ++n;  };
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    prelude.execute(global);
+    global.take_snapshot();
+    ASTERIA_TEST_CHECK(global.get_snapshot_opt());
+    ASTERIA_TEST_CHECK(global.get_snapshot_opt()->count_variables() >= 3);  // std, counter, n
+
+    Simple_Script handler;
+    handler.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        var r = counter() + counter();
+        counter = null;
+        return r;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+
+    // Each execution after a reset sees the state of the prelude.
+    for(int k = 0;  k != 3;  ++k) {
+      ASTERIA_TEST_CHECK(handler.execute(global).dereference_readonly().as_integer() == 3);
+      ASTERIA_TEST_CHECK(var->get_value().is_null());
+      ASTERIA_TEST_CHECK_CATCH(handler.execute(global));
+
+      global.open_named_reference(sref("extra")) = Reference::S_constant();
+      global.reset_to_snapshot();
+      ASTERIA_TEST_CHECK(var->get_value().is_function());
+      ASTERIA_TEST_CHECK(global.get_named_reference_opt(sref("extra")) == nullptr);
+    }
+
+    global.discard_snapshot();
+    ASTERIA_TEST_CHECK(!global.get_snapshot_opt());
+    ASTERIA_TEST_CHECK_CATCH(global.reset_to_snapshot());
+  }
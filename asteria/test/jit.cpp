@@ -0,0 +1,128 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../src/simple_script.hpp"
+#include "../src/runtime/global_context.hpp"
+
+using namespace asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        // Functions are called enough times to get translated, so results before
+        // and after translation must agree.
+        func add(x, y) { return x + y;  }
+        func fib(n) { return n <= 1 ? n : fib(n - 1) + fib(n - 2);  }
+        func loop(n) {
+          var s = 0;
+          for(var i = 0;  i < n;  ++i)
+            s = add(s, i);
+          return s;
+        }
+        for(var i = 0;  i < 100;  ++i) {
+          assert add(i, 1) == i + 1;
+          assert loop(i) == i * (i - 1) / 2;
+        }
+        assert fib(20) == 6765;
+
+        // Blocks and loop bodies are translated on their own, so `break` and
+        // `continue` are passed through nested native code.
+        func scan(n) {
+          var s = 0;
+          for(var i = 0;  ;  ++i) {
+            if(i >= n)
+              break;
+            if(i % 3 == 0) {
+              continue;
+            }
+            {
+              s += i;
+            }
+          }
+          return s;
+        }
+        for(var i = 0;  i < 50;  ++i) {
+          var e = 0;
+          for(var j = 0;  j < i;  ++j)
+            if(j % 3 != 0)
+              e += j;
+          assert scan(i) == e;
+        }
+
+        // References and void results.
+        var a = [ 1, 2, 3 ];
+        func elem(k) { return ref a[k];  }
+        func nothing() { }
+        for(var i = 0;  i < 100;  ++i) {
+          elem(i % 3) += 1;
+          nothing();
+        }
+        assert a == [ 35, 35, 36 ];
+
+        // Proper tail calls.
+        func down(n) { if(n == 0) return "done";  return down(n - 1);  }
+        for(var i = 0;  i < 50;  ++i)
+          assert down(1000) == "done";
+
+        // Deferred expressions.
+        var log = [];
+        func logged(x) { defer log[$] = x;  return x * 2;  }
+        for(var i = 0;  i < 50;  ++i)
+          assert logged(i) == i * 2;
+        assert countof log == 50;
+        assert log[49] == 49;
+
+        // Exceptions are propagated through native code, with backtraces.
+        func fail(x) {
+          var y = x + 1;
+          throw y;
+        }
+        for(var i = 0;  i < 50;  ++i)
+          try {
+            fail(i);
+            assert false;
+          }
+          catch(e) {
+            assert e == i + 1;
+            var found = false;
+            for(each k, v -> __backtrace)
+              found ||= (std.string.find(v.frame, "function") != null) && (v.value == "fail(x)");
+            assert found;
+          }
+
+        // Exceptions are propagated through nested loops.
+        func deep(n) {
+          while(true) {
+            for(var i = 0;  i < 100;  ++i)
+              if(i == n)
+                throw i;
+          }
+        }
+        for(var i = 0;  i < 50;  ++i)
+          try {
+            deep(i);
+            assert false;
+          }
+          catch(e)
+            assert e == i;
+
+        // Runtime errors, too.
+        func bad(x) { return x + "meow";  }
+        for(var i = 0;  i < 50;  ++i)
+          try {
+            bad(i);
+            assert false;
+          }
+          catch(e)
+            assert std.string.find(e, "meow") != null;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    Global_Context global;
+    code.execute(global);
+  }
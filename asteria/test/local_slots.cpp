@@ -0,0 +1,99 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../src/simple_script.hpp"
+#include "../src/runtime/global_context.hpp"
+#include "../src/llds/reference_dictionary.hpp"
+
+using namespace asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        // Locals following parameters.
+        func calc(a, b) {
+          var c = a + b;
+          const d = c * a;
+          return [ a, b, c, d ];
+        }
+        assert calc(2, 3) == [ 2, 3, 5, 10 ];
+        assert calc(1, 1) == [ 1, 1, 2, 2 ];
+
+        // Pre-defined references interleaved with locals.
+        func meta(x, ...) {
+          var y = x;
+          var n = __varg();
+          var z = __func;
+          return [ y, n, z ];
+        }
+        assert meta(1) == [ 1, 0, "meta(x, ...)" ];
+        assert meta(1, 2, 3) == [ 1, 2, "meta(x, ...)" ];
+
+        // `this` is set before locals at runtime, but not at compile time.
+        func method(p) {
+          var q = p + 1;
+          return [ this.k, p, q ];
+        }
+        var obj = { k: "v", method: method };
+        assert obj.method(4) == [ "v", 4, 5 ];
+        assert method(4) == [ null, 4, 5 ];
+
+        // Names declared conditionally.
+        func cond(f) {
+          if(f)
+            return __this;
+          var w = 42;
+          return w;
+        }
+        assert cond(false) == 42;
+        assert cond(true) == null;
+
+        // Shadowing in nested blocks and closures.
+        var outer = 1;
+        {
+          var outer = 2;
+          var inner = outer + 1;
+          assert inner == 3;
+        }
+        assert outer == 1;
+        func make(seed) {
+          var acc = seed;
+          return func(n) { acc += n;  return acc;  };
+        }
+        var add = make(10);
+        assert add(1) == 11;
+        assert add(2) == 13;
+
+        // Many locals, to trigger rehashing of the dictionary.
+        var v0 = 0; var v1 = 1; var v2 = 2; var v3 = 3; var v4 = 4;
+        var v5 = 5; var v6 = 6; var v7 = 7; var v8 = 8; var v9 = 9;
+        var va = 10; var vb = 11; var vc = 12; var vd = 13; var ve = 14;
+        var vf = 15; var vg = 16; var vh = 17; var vi = 18; var vj = 19;
+        assert v0 + v5 + va + vf + vj == 49;
+        assert outer == 1;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    Global_Context global;
+    code.execute(global);
+
+    // Slots of erased names are reused, so the table doesn't keep growing.
+    Reference_Dictionary dict;
+    const phsh_string first = sref("first");
+    dict.open(first);
+    ASTERIA_TEST_CHECK(dict.find_slot(first) == 0);
+    for(int k = 0;  k != 100000;  ++k) {
+      const phsh_string name = cow_string(("temp" + ::std::to_string(k)).c_str());
+      dict.open(name);
+      ASTERIA_TEST_CHECK(dict.find_slot(name) < 100);
+      ASTERIA_TEST_CHECK(dict.erase(name));
+    }
+    ASTERIA_TEST_CHECK(dict.size() == 1);
+    ASTERIA_TEST_CHECK(dict.find_slot(first) == 0);
+    ASTERIA_TEST_CHECK(dict.find_opt(first, 0) == dict.find_opt(first));
+  }
@@ -0,0 +1,111 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../src/simple_script.hpp"
+#include "../src/runtime/global_context.hpp"
+#include "../src/runtime/node_counters.hpp"
+
+using namespace asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func fib(n) {
+          return n <= 1 ? n : fib(n - 1) + fib(n - 2);
+        }
+        return fib(15);
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+
+    // Install counters via the API.
+    Global_Context global;
+    auto ncount = ::rocket::make_refcnt<Node_Counters>();
+    global.set_node_counters(ncount);
+    ASTERIA_TEST_CHECK(code.execute(global).dereference_readonly().as_integer() == 610);
+
+    uint64_t ncalls = 0;
+    for(const auto& r : ncount->collect())
+      if(r.name == "function_call")
+        ncalls = r.count;
+    ASTERIA_TEST_CHECK(ncalls == 1973);
+
+    auto records = ncount->collect();
+    ASTERIA_TEST_CHECK(records.size() > 1);
+    for(size_t k = 1;  k < records.size();  ++k)
+      ASTERIA_TEST_CHECK(records[k-1].cycles >= records[k].cycles);
+
+    ncount->clear();
+    ASTERIA_TEST_CHECK(ncount->collect().empty());
+
+    global.set_node_counters(rcptr<Node_Counters>());
+    code.execute(global);
+    ASTERIA_TEST_CHECK(ncount->collect().empty());
+
+    // Use the standard library.
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        assert std.debug.node_counters_get() == null;
+        assert std.debug.node_counters_stop() == null;
+
+        func loop(n) {
+          var s = 0;
+          for(var i = 0;  i < n;  ++i)
+            s += i;
+          return s;
+        }
+
+        std.debug.node_counters_start();
+        loop(100);
+        var r = std.debug.node_counters_get();
+        assert typeof r == "array";
+        assert countof r > 0;
+
+        for(each k, v -> r) {
+          assert typeof v.name == "string";
+          assert v.count > 0;
+          assert v.cycles >= 0;
+        }
+
+        std.debug.node_counters_start();
+        loop(100);
+        r = std.debug.node_counters_stop();
+        assert countof r > 0;
+        assert std.debug.node_counters_get() == null;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    code.execute(global);
+
+    // Counters may be stopped while enclosing nodes are still being measured.
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        std.debug.node_counters_start();
+        {
+          var r = std.debug.node_counters_stop();
+          assert countof r > 0;
+        }
+        assert std.debug.node_counters_get() == null;
+
+        func stop() {
+          return std.debug.node_counters_stop();
+        }
+        std.debug.node_counters_start();
+        for(var i = 0;  i < 3;  ++i)
+          if(i == 1)
+            assert countof stop() > 0;
+        assert std.debug.node_counters_get() == null;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    code.execute(global);
+  }
@@ -0,0 +1,88 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../src/simple_script.hpp"
+#include "../src/runtime/global_context.hpp"
+
+using namespace asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func add(x, y) { return x + y;  }
+        func sub(x, y) { return x - y;  }
+        func mul(x, y) { return x * y;  }
+        func less(x, y) { return x < y;  }
+        func equal(x, y) { return x == y;  }
+
+        // Warm up nodes with integers, then break their guards.
+        for(var i = 0;  i < 10;  ++i) {
+          assert add(i, 2) == i + 2;
+          assert sub(i, 2) == i - 2;
+          assert mul(i, 3) == i * 3;
+          assert less(i, 5) == (i < 5);
+          assert equal(i, 5) == (i == 5);
+        }
+        assert add(1.5, 2) == 3.5;
+        assert add(1, 2.5) == 3.5;
+        assert add("a", "b") == "ab";
+        assert sub(true, false) == true;
+        assert mul("ab", 2) == "abab";
+        assert less(1.5, 2) == true;
+        assert equal("a", "a") == true;
+        assert add(1, 2) == 3;
+
+        // Warm up nodes with reals and strings.
+        for(var i = 0;  i < 10;  ++i) {
+          assert add(i + 0.5, 0.25) == i + 0.75;
+          assert mul(i + 0.5, 2.0) == i * 2 + 1;
+          assert less("abc", "abd") == true;
+          assert less("abd", "abc") == false;
+          assert equal("abc", "abc") == true;
+          assert equal("abc", "ab") == false;
+        }
+        assert add(1, 2) == 3;
+        assert less(1, 2) == true;
+
+        // Errors must be reported the same way in monomorphic nodes.
+        func mul2(x, y) { return x * y;  }
+        func less2(x, y) { return x < y;  }
+        for(var i = 0;  i < 10;  ++i) {
+          assert mul2(i, i) == i * i;
+          assert less2(i + 0.5, 1.0) == (i == 0);
+        }
+        try {
+          mul2(0x7FFFFFFFFFFFFFFF, 2);
+          assert false;
+        }
+        catch(e)
+          assert std.string.find(e, "Integer multiplication overflow") != null;
+        try {
+          less2(nan, 1.0);
+          assert false;
+        }
+        catch(e)
+          assert std.string.find(e, "Values not comparable") != null;
+        assert mul2(6, 7) == 42;
+        assert less2(0.5, 1.0) == true;
+
+        // Compound assignment operates on variables.
+        var s = 0;
+        for(var i = 0;  i < 10;  ++i)
+          s += i;
+        assert s == 45;
+        var r = 1.0;
+        for(var i = 0;  i < 10;  ++i)
+          r *= 2.0;
+        assert r == 1024;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    Global_Context global;
+    code.execute(global);
+  }
@@ -70,4 +70,37 @@ int main()
     ASTERIA_TEST_CHECK(val.is_null());
     val = ref.dereference_unset();
     ASTERIA_TEST_CHECK(val.is_null());
+
+    var->initialize(V_null(), false);
+    ref = Reference::S_variable { var };
+    for(auto key : { "a", "b", "c", "d", "e" })
+      ref.zoom_in(Reference::M_object_key { phsh_string(sref(key)) });
+    ref.dereference_mutable() = V_integer(7);
+    auto ref3 = ref;
+    ref3.zoom_out();
+    ref3.zoom_out();
+    ref3.zoom_in(Reference::M_object_key { phsh_string(sref("d")) });
+    ref3.zoom_in(Reference::M_object_key { phsh_string(sref("e")) });
+    val = ref3.dereference_readonly();
+    ASTERIA_TEST_CHECK(val.is_integer());
+    ASTERIA_TEST_CHECK(val.as_integer() == 7);
+    for(int k = 0;  k != 5;  ++k)
+      ref3.zoom_out();
+    ASTERIA_TEST_CHECK(ref3.is_variable());
+    ASTERIA_TEST_CHECK(ref3.dereference_readonly().is_object());
+    ref3.zoom_out();
+    ASTERIA_TEST_CHECK(ref3.is_constant());
+    val = ref.dereference_unset();
+    ASTERIA_TEST_CHECK(val.is_integer());
+    ASTERIA_TEST_CHECK(val.as_integer() == 7);
+
+    // Modifiers are replaced by those of the source, even if there are none.
+    Reference root = Reference::S_variable { var };
+    ref3 = ref;
+    ref = root;
+    ASTERIA_TEST_CHECK(ref.dereference_readonly().is_object());
+    ref3 = ::std::move(root);
+    ASTERIA_TEST_CHECK(ref3.dereference_readonly().is_object());
+    ref.zoom_in(Reference::M_object_key { phsh_string(sref("a")) });
+    ASTERIA_TEST_CHECK(ref.dereference_readonly().is_object());
   }
@@ -0,0 +1,61 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../src/simple_script.hpp"
+#include "../src/runtime/global_context.hpp"
+#include "../src/runtime/sampling_profiler.hpp"
+
+using namespace asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func fib(n) {
+          return n <= 1 ? n : fib(n - 1) + fib(n - 2);
+        }
+        func spin() {
+          var t = std.chrono.hires_now() + 300;
+          var s = 0;
+          while(std.chrono.hires_now() < t)
+            s += fib(12);
+          return s;
+        }
+        return spin();
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+
+    Global_Context global;
+    auto prof = ::rocket::make_refcnt<Sampling_Profiler>();
+    global.set_profiler(prof);
+    ASTERIA_TEST_CHECK_CATCH(prof->start(0));
+    ASTERIA_TEST_CHECK(prof->is_running() == false);
+
+    prof->start(1000);
+    ASTERIA_TEST_CHECK(prof->is_running());
+    code.execute(global);
+    prof->stop();
+    ASTERIA_TEST_CHECK(prof->is_running() == false);
+    ASTERIA_TEST_CHECK(global.get_sampling_frame_opt() == nullptr);
+
+    // Samples are taken from nested function calls.
+    ASTERIA_TEST_CHECK(prof->count_samples() > 0);
+    ::rocket::tinyfmt_str fmt;
+    prof->print_folded(fmt);
+    const auto& str = fmt.get_string();
+    ASTERIA_TEST_CHECK(str.find("spin()") != cow_string::npos);
+    ASTERIA_TEST_CHECK(str.find(";fib(n)") != cow_string::npos);
+
+    // No more samples are taken after the profiler stops.
+    uint64_t nsamples = prof->count_samples();
+    code.execute(global);
+    ASTERIA_TEST_CHECK(prof->count_samples() == nsamples);
+
+    prof->clear();
+    ASTERIA_TEST_CHECK(prof->count_samples() == 0);
+  }
@@ -0,0 +1,92 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../src/script_pool.hpp"
+#include "../src/runtime/global_context.hpp"
+#include "../src/runtime/reference.hpp"
+#include <pthread.h>
+
+using namespace asteria;
+
+namespace {
+
+Script_Pool pool;
+
+void*
+do_thread(void* param)
+  {
+    auto& nfails = *static_cast<size_t*>(param);
+    for(int k = 0;  k != 100;  ++k) {
+      auto lease = pool.acquire();
+      auto res = lease.execute({ V_integer(k % 16) });
+      int64_t fibs[16] = { 0,1,1,2,3,5,8,13,21,34,55,89,144,233,377,610 };
+      if(res.dereference_readonly().as_integer() != fibs[k % 16])
+        nfails++;
+    }
+    return nullptr;
+  }
+
+}  // namespace
+
+int main()
+  {
+    ASTERIA_TEST_CHECK(!pool);
+    ASTERIA_TEST_CHECK_CATCH(pool.acquire());
+
+    pool.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func fib(n) {
+          return n <= 1 ? n : fib(n - 1) + fib(n - 2);
+        }
+        return fib(__varg(0));
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    ASTERIA_TEST_CHECK(pool);
+
+    // Execute the script in multiple threads concurrently.
+    ::pthread_t threads[8];
+    size_t nfails[8] = { };
+    for(size_t k = 0;  k != 8;  ++k)
+      ASTERIA_TEST_CHECK(::pthread_create(threads + k, nullptr, do_thread, nfails + k) == 0);
+    for(size_t k = 0;  k != 8;  ++k)
+      ASTERIA_TEST_CHECK(::pthread_join(threads[k], nullptr) == 0);
+    for(size_t k = 0;  k != 8;  ++k)
+      ASTERIA_TEST_CHECK(nfails[k] == 0);
+
+    // Instances have been returned, and are reused.
+    size_t nidle = pool.count_idle();
+    ASTERIA_TEST_CHECK(nidle >= 1);
+    ASTERIA_TEST_CHECK(nidle <= 8);
+    {
+      auto lease = pool.acquire();
+      ASTERIA_TEST_CHECK(pool.count_idle() == nidle - 1);
+
+      // Instances that are leased at the same time have distinct global contexts.
+      auto other = pool.acquire();
+      ASTERIA_TEST_CHECK(&(lease.global()) != &(other.global()));
+      ASTERIA_TEST_CHECK(other.execute({ V_integer(10) }).dereference_readonly().as_integer() == 55);
+      nidle = pool.count_idle();
+
+      // Discarded instances are not returned.
+      other.release(true);
+      ASTERIA_TEST_CHECK(!other);
+      ASTERIA_TEST_CHECK_CATCH(other.execute());
+    }
+    ASTERIA_TEST_CHECK(pool.count_idle() == nidle + 1);
+
+    pool.set_max_idle(1);
+    ASTERIA_TEST_CHECK(pool.count_idle() == 1);
+
+    // Reloading destroys idle instances, as well as ones that are leased.
+    auto lease = pool.acquire();
+    pool.reload_string(sref("new"), sref("return 42;"));
+    ASTERIA_TEST_CHECK(pool.count_idle() == 0);
+    lease.release();
+    ASTERIA_TEST_CHECK(pool.count_idle() == 0);
+    lease = pool.acquire();
+    ASTERIA_TEST_CHECK(lease.execute().dereference_readonly().as_integer() == 42);
+  }
@@ -0,0 +1,32 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../src/runtime/global_context.hpp"
+#include "../src/runtime/variable.hpp"
+
+using namespace asteria;
+
+int main()
+  {
+    // The standard library is shared by global contexts of the same version.
+    Global_Context first;
+    Global_Context second;
+    const auto& ostd1 = first.std_variable()->get_value().as_object();
+    const auto& ostd2 = second.std_variable()->get_value().as_object();
+    ASTERIA_TEST_CHECK(ostd1.size() == ostd2.size());
+    ASTERIA_TEST_CHECK(&(ostd1.find(sref("math"))->second) == &(ostd2.find(sref("math"))->second));
+
+    Global_Context old(api_version_none);
+    const auto& ostd3 = old.std_variable()->get_value().as_object();
+    ASTERIA_TEST_CHECK(ostd3.count(sref("version")) == 1);
+    ASTERIA_TEST_CHECK(ostd3.count(sref("math")) == 0);
+
+    // Modifying one copy doesn't affect others.
+    first.std_variable()->open_value().open_object().erase(sref("math"));
+    ASTERIA_TEST_CHECK(first.std_variable()->get_value().as_object().count(sref("math")) == 0);
+    ASTERIA_TEST_CHECK(second.std_variable()->get_value().as_object().count(sref("math")) == 1);
+
+    Global_Context third;
+    ASTERIA_TEST_CHECK(third.std_variable()->get_value().as_object().count(sref("math")) == 1);
+  }
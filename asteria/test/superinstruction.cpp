@@ -0,0 +1,70 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../src/simple_script.hpp"
+#include "../src/runtime/global_context.hpp"
+
+using namespace asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func id(x) { return x;  }
+
+        var i = 5, r = 2.5, s = "a", n = null;
+
+        // integer fast paths
+        assert i + 1 == 6;
+        assert i - 1 == 4;
+        assert i + -7 == -2;
+        assert (i == 5) == true;
+        assert (i != 5) == false;
+        assert (i < 6) && !(i < 5);
+        assert (i > 4) && !(i > 5);
+        assert (i <= 5) && !(i <= 4);
+        assert (i >= 5) && !(i >= 6);
+        i += 10;
+        assert i == 15;
+        i -= 20;
+        assert i == -5;
+
+        // generic fallbacks
+        assert r + 1 == 3.5;
+        assert r - 1 == 1.5;
+        assert r < 3;
+        assert (s == 1) == false;
+        assert (n != 0) == true;
+        try {
+          s + 1;
+          assert false;
+        }
+        catch(e)
+          assert std.string.find(e, "Infix addition not applicable") != null;
+
+        // overflows
+        var m = 0x7FFFFFFFFFFFFFFF;
+        try {
+          m + 1;
+          assert false;
+        }
+        catch(e)
+          assert std.string.find(e, "Integer addition overflow") != null;
+        assert m - 1 == 0x7FFFFFFFFFFFFFFE;
+
+        // local references as arguments by value
+        var a = [ 1, 2 ];
+        var b = id(a);
+        b[0] = 3;
+        assert a[0] == 1;
+        assert id(i) == -5;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    Global_Context global;
+    code.execute(global);
+  }
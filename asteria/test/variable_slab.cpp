@@ -0,0 +1,116 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2020, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../src/runtime/variable.hpp"
+#include <pthread.h>
+
+using namespace asteria;
+
+::std::atomic<long> bcnt;
+
+void* operator new(size_t cb)
+  {
+    auto ptr = ::std::malloc(cb);
+    if(!ptr)
+      throw ::std::bad_alloc();
+
+    bcnt.fetch_add(1, ::std::memory_order_relaxed);
+    return ptr;
+  }
+
+void operator delete(void* ptr) noexcept
+  {
+    if(!ptr)
+      return;
+
+    bcnt.fetch_sub(1, ::std::memory_order_relaxed);
+    ::std::free(ptr);
+  }
+
+void operator delete(void* ptr, size_t) noexcept
+  {
+    operator delete(ptr);
+  }
+
+namespace {
+
+cow_vector<rcptr<Variable>> vars;
+
+void*
+do_thread(void* /*param*/)
+  {
+    // Variables are allocated from a new page in a new thread.
+    for(size_t k = 0;  k != 10000;  ++k) {
+      auto var = ::rocket::make_refcnt<Variable>();
+      var->initialize(V_integer(static_cast<int64_t>(k)), false);
+      vars.emplace_back(::std::move(var));
+    }
+    return nullptr;
+  }
+
+void*
+do_free_thread(void* /*param*/)
+  {
+    // This thread never allocates, so its slots are only returned at exit.
+    vars.clear();
+    return nullptr;
+  }
+
+struct Static_Holder
+  {
+    cow_vector<rcptr<Variable>> vars;
+
+    ~Static_Holder()
+      {
+        // This is called after thread-local objects of the main thread have been
+        // destroyed, so slots must be still usable.
+        this->vars.clear();
+        for(size_t k = 0;  k != 1000;  ++k)
+          ::rocket::make_refcnt<Variable>();
+      }
+  }
+holder;
+
+}  // namespace
+
+int main()
+  {
+    ::pthread_t thrd;
+    ASTERIA_TEST_CHECK(::pthread_create(&thrd, nullptr, do_thread, nullptr) == 0);
+    ASTERIA_TEST_CHECK(::pthread_join(thrd, nullptr) == 0);
+
+    // Variables that are allocated consecutively are adjacent.
+    ASTERIA_TEST_CHECK(vars.size() == 10000);
+    auto addr = [&](size_t k) { return reinterpret_cast<uintptr_t>(vars[k].get());  };
+    uintptr_t stride = addr(1) - addr(0);
+    ASTERIA_TEST_CHECK(stride >= sizeof(Variable));
+    ASTERIA_TEST_CHECK(stride < sizeof(Variable) * 2);
+    size_t nadj = 0;
+    for(size_t k = 1;  k != vars.size();  ++k)
+      nadj += (addr(k) - addr(k-1) == stride);
+    ASTERIA_TEST_CHECK(nadj > 9000);
+
+    for(size_t k = 0;  k != vars.size();  ++k)
+      ASTERIA_TEST_CHECK(vars[k]->get_value().as_integer() == static_cast<int64_t>(k));
+
+    // Free slots are reused by other threads.
+    const Variable* last = vars.back().get();
+    vars.pop_back();
+    auto var = ::rocket::make_refcnt<Variable>();
+    ASTERIA_TEST_CHECK(var.get() == last);
+    vars.clear();
+
+    // Slots that are freed by a thread are returned when it exits, and pages
+    // that become empty are released.
+    long base = bcnt.load(::std::memory_order_relaxed);
+    ASTERIA_TEST_CHECK(::pthread_create(&thrd, nullptr, do_thread, nullptr) == 0);
+    ASTERIA_TEST_CHECK(::pthread_join(thrd, nullptr) == 0);
+    ASTERIA_TEST_CHECK(bcnt.load(::std::memory_order_relaxed) > base);
+    ASTERIA_TEST_CHECK(::pthread_create(&thrd, nullptr, do_free_thread, nullptr) == 0);
+    ASTERIA_TEST_CHECK(::pthread_join(thrd, nullptr) == 0);
+    ASTERIA_TEST_CHECK(bcnt.load(::std::memory_order_relaxed) == base);
+
+    for(size_t k = 0;  k != 2000;  ++k)
+      holder.vars.emplace_back(::rocket::make_refcnt<Variable>());
+  }
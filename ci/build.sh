@@ -13,3 +13,12 @@ make -j$(nproc)
 
 # test
 make -j$(nproc) check || (cat ./test-suite.log; false)
+
+# test again with all functions translated into native code
+if test "$(uname -m)" == "x86_64"
+then
+  ./configure --disable-silent-rules --enable-debug-checks --disable-static --enable-jit=force
+  make -j$(nproc) clean
+  make -j$(nproc)
+  make -j$(nproc) check || (cat ./test-suite.log; false)
+fi